@@ -2,13 +2,25 @@
 #define CELLULAR_AUTOMATON_HPP
 
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 #include <array>
 #include <memory>
 #include <tuple>
+#include <utility>
+#include <optional>
+#include <cstdint>
 #include <iostream>
+#include <atomic>
+#include <algorithm>
+#include <type_traits>
+#include <bit>
 #include "rules/rule_base.hpp"
+#include "rules/rule_concept.hpp"
+#include "cell_automaton/neighbor_counter.hpp"
+#include "cell_automaton/density_pyramid.hpp"
+#include "cell_automaton/edit_queue.hpp"
+#include "cell_automaton/step_strategy.hpp"
+#include "cell_automaton/symmetry.hpp"
 
 
 using namespace cell_automaton::rules;
@@ -21,85 +33,700 @@ using namespace cell_automaton::rules;
 constexpr size_t CHUNK_SIZE = 64;
 constexpr double DENSITY_THRESHOLD = 0.3;
 
-template<typename StateT>
-struct Coord {
+// One 64-bit word per chunk row, bit x set = local cell (x, row) selected
+using ChunkBits = std::array<uint64_t, CHUNK_SIZE>;
+static_assert(CHUNK_SIZE == 64, "ChunkBits assumes one 64-bit word per chunk row");
+
+// Hash specialization for ChunkCoord (pair<int32_t, int32_t>)
+struct ChunkCoordHash {
+    size_t operator()(const std::pair<int32_t, int32_t>& p) const {
+        return std::hash<int64_t>{}((int64_t(p.first) << 32) | int64_t(p.second));
+    }
+};
+
+
+// Byte breakdown reported by CellularAutomaton::memory_usage()
+struct MemoryUsage {
+    size_t sparse_chunks = 0;
+    size_t dense_chunks = 0;
+    size_t sparse_bytes = 0;    // Chunk objects + packed sparse lists
+    size_t dense_bytes = 0;     // Chunk objects + dense arrays
+    size_t index_bytes = 0;     // Chunk map buckets and nodes
+    size_t frozen_chunks = 0;
+    size_t frozen_bytes = 0;    // Chunk objects + shared frozen blocks, each block counted once
+    size_t cycle_bytes = 0;     // Generations recorded for memoized replay
+    
+    size_t total_bytes() const { return sparse_bytes + dense_bytes + index_bytes + frozen_bytes + cycle_bytes; }
+};
+
+// Rectangle of world cells, [x, x + width) x [y, y + height)
+struct CellRect {
     int32_t x, y;
-    bool operator==(const Coord& other) const { return x == other.x && y == other.y; }
+    int32_t width, height;
 };
 
-template<typename StateT>
-struct CoordHash {
-    size_t operator()(const Coord<StateT>& c) const {
-        return std::hash<int64_t>{}((int64_t(c.x) << 32) | int64_t(c.y));
-    }
+// Inclusive bounds of all non-default cells
+struct BoundingBox {
+    int32_t min_x, min_y;
+    int32_t max_x, max_y;
 };
 
-template<typename StateT>
-struct PairHash {
-    size_t operator()(const std::pair<int32_t, int32_t>& p) const {
-        return std::hash<int64_t>{}((int64_t(p.first) << 32) | int64_t(p.second));
+/**
+ * Downsampled live-cell counts returned by query_density().
+ * Pixel (i, j) covers cells [x + i * cell_size, x + (i + 1) * cell_size) by
+ * [y + j * cell_size, y + (j + 1) * cell_size); x and y are multiples of cell_size.
+ */
+struct DensityRaster {
+    int32_t x = 0, y = 0;
+    int32_t cell_size = 1;
+    int width = 0, height = 0;
+    std::vector<uint32_t> counts;   // Row-major, width * height
+    
+    double density(int i, int j) const {
+        return counts[size_t(j) * width + i] / (double(cell_size) * cell_size);
     }
 };
 
-// Hash specialization for ChunkCoord (pair<int32_t, int32_t>)
-struct ChunkCoordHash {
-    size_t operator()(const std::pair<int32_t, int32_t>& p) const {
-        return std::hash<int64_t>{}((int64_t(p.first) << 32) | int64_t(p.second));
+/**
+ * Immutable contents of a settled chunk.
+ *
+ * Stored as whichever is smaller: the ascending packed keys, or an occupancy
+ * bitmap with per-row value offsets. States follow in key order, except for
+ * bool whose only non-default state is true. Blocks are shared between
+ * generations and between identical chunks, so they are never modified.
+ */
+template<typename StateT>
+class FrozenCells {
+private:
+    std::vector<uint16_t> keys;                    // Empty when the bitmap is used
+    std::vector<uint64_t> rows;                    // One word per row, or empty
+    std::vector<uint16_t> row_start;               // Values before each row, bitmap only
+    std::vector<StateT> values;                    // Empty for bool
+    size_t population = 0;
+    uint64_t hash = 0;
+    
+    static constexpr bool STORES_VALUES = !std::is_same_v<StateT, bool>;
+    
+    StateT value_at(size_t index) const {
+        if constexpr (STORES_VALUES) return values[index];
+        else return true;
+    }
+    
+public:
+    // From ascending packed keys and their states, with the chunk's content hash
+    FrozenCells(const std::vector<uint16_t>& keys, const std::vector<StateT>& values, uint64_t hash);
+    
+    StateT get(uint16_t key) const;
+    bool matches(const std::vector<uint16_t>& keys, const std::vector<StateT>& values) const;
+    // Same against a row-major CHUNK_SIZE^2 array holding `live` non-default cells
+    bool matches(const StateT* cells, size_t live) const;
+    size_t get_population() const { return population; }
+    uint64_t content_hash() const { return hash; }
+    size_t memory_usage() const;
+    
+    // Call fn(x, y, state) for every cell in [x0, x0 + w) x [y0, y0 + h), row-major
+    template<typename Fn>
+    void for_each_in(int x0, int y0, int w, int h, Fn&& fn) const {
+        if (rows.empty()) {
+            const uint16_t first = static_cast<uint16_t>(y0 * CHUNK_SIZE + x0);
+            const uint16_t last = static_cast<uint16_t>((y0 + h) * CHUNK_SIZE);
+            for (auto it = std::lower_bound(keys.begin(), keys.end(), first); it != keys.end() && *it < last; ++it) {
+                const int x = *it % CHUNK_SIZE;
+                if (x >= x0 && x < x0 + w) fn(x, int(*it / CHUNK_SIZE), value_at(it - keys.begin()));
+            }
+            return;
+        }
+        const uint64_t window = (w >= int(CHUNK_SIZE) ? ~uint64_t(0) : ((uint64_t(1) << w) - 1)) << x0;
+        for (int y = y0; y < y0 + h; ++y) {
+            for (uint64_t bits = rows[y] & window; bits; bits &= bits - 1) {
+                const int x = std::countr_zero(bits);
+                if constexpr (STORES_VALUES) {
+                    fn(x, y, values[row_start[y] + std::popcount(rows[y] & ((uint64_t(1) << x) - 1))]);
+                } else {
+                    fn(x, y, StateT(true));
+                }
+            }
+        }
     }
 };
 
-
+/**
+ * A CHUNK_SIZE x CHUNK_SIZE tile of cells.
+ *
+ * Sparse, dense and frozen storage are mutually exclusive. Sparse chunks keep
+ * a sorted list of packed 12-bit local coordinates (y * CHUNK_SIZE + x) with a
+ * parallel list of states; dense chunks own a heap-allocated array that only
+ * exists while the chunk is dense. Frozen chunks point at a shared, immutable
+ * FrozenCells block; copying one shares the block, and the first write thaws
+ * the chunk back into private sparse or dense storage. freeze() frees the
+ * private buffers; a chunk assigned a frozen copy keeps them, empty, for its
+ * next thaw or assignment until trim().
+ */
 template<typename StateT>
 class Chunk {
 private:
+    using DenseStorage = std::array<StateT, CHUNK_SIZE * CHUNK_SIZE>;
+    
     bool is_dense = false;
-    std::unordered_map<Coord<StateT>, StateT, CoordHash<StateT>> sparse_data;
-    std::array<StateT, CHUNK_SIZE * CHUNK_SIZE> dense_data;
+    uint8_t steady = 0;         // Consecutive generations without a change, saturating
+    uint16_t population = 0;    // Non-default cells, kept in every mode
+    std::vector<uint16_t> sparse_keys;
+    std::vector<StateT> sparse_values;
+    std::unique_ptr<DenseStorage> dense_data;
+    std::shared_ptr<const FrozenCells<StateT>> frozen;
+    
+    static uint16_t pack_local(int x, int y) { return static_cast<uint16_t>(y * CHUNK_SIZE + x); }
+    
+    // Write one cell without considering a storage switch
+    void store(uint16_t key, StateT state);
+    // Drop the private buffers, keeping only the frozen block
+    void release_buffers();
     
 public:
+    using Frozen = std::shared_ptr<const FrozenCells<StateT>>;
+    
+    // Replace the contents with a shared frozen block, which must not be null
+    void freeze(Frozen block);
+    // Back to private sparse or dense storage; no-op unless frozen
+    void thaw();
+    // Free the buffers a frozen chunk keeps as scratch; no-op unless frozen
+    void trim();
+    bool is_frozen() const { return frozen != nullptr; }
+    const FrozenCells<StateT>* frozen_block() const { return frozen.get(); }
+    // Ascending packed keys and states of the live cells, appended to keys / values
+    void collect(std::vector<uint16_t>& keys, std::vector<StateT>& values) const;
+    
+    uint8_t steady_steps() const { return steady; }
+    void set_steady_steps(uint8_t steps) { steady = steps; }
+    
     void convert_to_dense();
     void convert_to_sparse();
     StateT get_cell(int x, int y) const;
     void set_cell(int x, int y, StateT state);
+    // Set every cell whose bit is set in rows to state, choosing storage once
+    void stamp_bits(const ChunkBits& rows, StateT state);
+    // Replace all cells from a row-major CHUNK_SIZE^2 array with known population;
+    // was_dense applies the same hysteresis as set_cell across generations
+    void assign_cells(const StateT* cells, size_t live_cells, bool was_dense);
+    // Replace all cells from ascending packed keys and their states
+    void assign_sparse(const std::vector<uint16_t>& keys, const std::vector<StateT>& values, bool was_dense);
+    // Copy [x0, x0 + w) x [y0, y0 + h) into out (row stride out_stride); out must
+    // be pre-filled with the default state. Returns the non-default cells copied.
+    size_t copy_region(int x0, int y0, int w, int h, StateT* out, size_t out_stride) const;
     bool is_empty() const;
     bool should_be_dense() const;
     bool should_be_sparse() const;
+    
+    Chunk() = default;
+    Chunk(const Chunk& other);
+    Chunk& operator=(const Chunk& other);
+    
+    // Call fn(x, y, state) for every non-default cell in row-major order
+    template<typename Fn>
+    void for_each_live(Fn&& fn) const {
+        if (frozen) {
+            frozen->for_each_in(0, 0, CHUNK_SIZE, CHUNK_SIZE, fn);
+        } else if (is_dense) {
+            for (uint16_t key = 0; key < CHUNK_SIZE * CHUNK_SIZE; ++key) {
+                if ((*dense_data)[key] != StateT{}) fn(key % CHUNK_SIZE, key / CHUNK_SIZE, (*dense_data)[key]);
+            }
+        } else {
+            for (size_t i = 0; i < sparse_keys.size(); ++i) {
+                fn(sparse_keys[i] % CHUNK_SIZE, sparse_keys[i] / CHUNK_SIZE, sparse_values[i]);
+            }
+        }
+    }
+    
+    // Same, restricted to [x0, x0 + w) x [y0, y0 + h); sparse chunks only visit
+    // the keys of rows y0 .. y0 + h - 1
+    template<typename Fn>
+    void for_each_live_in(int x0, int y0, int w, int h, Fn&& fn) const {
+        if (frozen) {
+            frozen->for_each_in(x0, y0, w, h, fn);
+            return;
+        }
+        if (is_dense) {
+            for (int y = y0; y < y0 + h; ++y) {
+                for (int x = x0; x < x0 + w; ++x) {
+                    const StateT state = (*dense_data)[pack_local(x, y)];
+                    if (state != StateT{}) fn(x, y, state);
+                }
+            }
+            return;
+        }
+        const uint16_t last = pack_local(0, y0 + h);
+        for (auto it = std::lower_bound(sparse_keys.begin(), sparse_keys.end(), pack_local(x0, y0));
+             it != sparse_keys.end() && *it < last; ++it) {
+            const int x = *it % CHUNK_SIZE;
+            if (x >= x0 && x < x0 + w) fn(x, int(*it / CHUNK_SIZE), StateT(sparse_values[it - sparse_keys.begin()]));
+        }
+    }
+    
+    // Content hash that does not depend on the storage mode; 0 for an empty chunk
+    uint64_t content_hash() const;
+    // Whether both chunks hold the same cells, whatever their storage
+    bool same_cells(const Chunk& other) const;
+    
+    bool dense() const { return is_dense; }
+    size_t get_population() const { return population; }
+    // Bytes owned by this chunk, including the object itself but not a frozen block
+    size_t memory_usage() const;
 };
 
+/**
+ * One complete generation of the universe.
+ *
+ * The automaton keeps a small pool of these: the simulation thread computes
+ * the next generation into a spare one while readers keep querying the one
+ * they pinned. `readers` counts live GenerationSnapshot handles.
+ */
 template<typename StateT>
-class CellularAutomaton {
-private:
+struct Generation {
     using ChunkCoord = std::pair<int32_t, int32_t>;
     using ChunkMap = std::unordered_map<ChunkCoord, std::unique_ptr<Chunk<StateT>>, ChunkCoordHash>;
     
     ChunkMap chunks;
-    std::unique_ptr<Rule<StateT>> rule;
+    DensityPyramid pyramid;     // Population quadtree over `chunks`
+    int64_t number = 0;
+    mutable std::atomic<int> readers{0};
+};
+
+/**
+ * @tparam RuleT Any CellRule. The default, AnyRule, runs a virtual Rule;
+ *               other rule types need cellular_automaton_impl.hpp included
+ *               where the automaton is instantiated.
+ */
+template<typename StateT, CellRule<StateT> RuleT = AnyRule<StateT>>
+class CellularAutomaton;
+
+/**
+ * Read-only handle to a published generation.
+ *
+ * Safe to use from any thread while the owning automaton keeps stepping; the
+ * pinned generation is not modified or reclaimed until the handle is destroyed.
+ * The handle must not outlive the automaton.
+ */
+template<typename StateT>
+class GenerationSnapshot {
+private:
+    const Generation<StateT>* world = nullptr;
+    StateT default_state{};
+    Symmetry symmetry = Symmetry::None;
+    
+    template<typename S, CellRule<S> R> friend class CellularAutomaton;
+    GenerationSnapshot(const Generation<StateT>* w, StateT default_val, Symmetry sym)
+        : world(w), default_state(default_val), symmetry(sym) {}
+    
+public:
+    GenerationSnapshot(GenerationSnapshot&& other) noexcept
+        : world(std::exchange(other.world, nullptr)), default_state(other.default_state), symmetry(other.symmetry) {}
+    GenerationSnapshot& operator=(GenerationSnapshot&& other) noexcept;
+    GenerationSnapshot(const GenerationSnapshot&) = delete;
+    GenerationSnapshot& operator=(const GenerationSnapshot&) = delete;
+    ~GenerationSnapshot();
+    
+    StateT get_cell(int32_t x, int32_t y) const;
+    int64_t get_generation() const { return world->number; }
+    size_t get_active_chunks() const { return world->chunks.size(); }
+    DensityRaster query_density(const CellRect& rect, int level) const;
+    std::optional<BoundingBox> bounding_box() const;
+};
+
+template<typename StateT, CellRule<StateT> RuleT>
+class CellularAutomaton {
+private:
+    using ChunkCoord = typename Generation<StateT>::ChunkCoord;
+    using ChunkMap = typename Generation<StateT>::ChunkMap;
+    
+    friend class GenerationSnapshot<StateT>;
+    // Times the chunk index and single stepping kernels in micro_benchmark
+    friend struct MicroBenchmarkAccess;
+    
+    // Generation pool. Entries are never destroyed while the automaton lives,
+    // so a reader racing with the writer never touches freed memory; once
+    // unpinned, the chunks and pyramid of retired entries are released instead.
+    std::vector<std::unique_ptr<Generation<StateT>>> worlds;
+    Generation<StateT>* current = nullptr;                 // Writer's latest state
+    std::atomic<Generation<StateT>*> published{nullptr};   // What snapshot() hands out
+    
+    RuleT rule;
     StateT default_state;
-    int64_t generation = 0;
+    bool totalistic = false;                       // Cached is_totalistic_rule()
+    
+    // Cached from the rule; the tile halo grows with the neighborhood radius
+    Neighborhood neighborhood;
+    std::vector<std::pair<int, int>> neighbor_offsets;
+    std::vector<std::pair<int, int>> row_spans;     // [dy + halo] -> dx range, center included
+    int halo = 1;
+    int tile_size = CHUNK_SIZE + 2;
+    
+    // Per-step scratch, reused across generations
+    std::unique_ptr<StateT[]> tile;                // Chunk plus halo, row-major
+    std::unique_ptr<StateT[]> next_cells;          // Next state of the chunk being stepped
+    std::vector<uint8_t> live_mask;
+    std::vector<int32_t> neighbor_counts;
+    std::vector<StateT> neighbor_states;           // Gathered neighbors, AnyRule
+    std::unique_ptr<StateT[]> neighbor_buffer;     // Gathered neighbors, other rules of unspecialized size
+    std::vector<ptrdiff_t> gather_offsets;         // neighbor_offsets as indices into rows of gather_stride
+    int gather_stride = 0;
+    NeighborCounter counter;
+    // Per-step scratch below keeps its capacity, so once the world stops
+    // growing step() does not allocate
+    // A chunk position to step and the chunks around it, block[(dy + 1) * 3 + dx + 1].
+    // Under a symmetry a neighbor outside the stored domain is the image of a
+    // stored chunk; view maps its local coordinates to those of the stored chunk
+    struct Candidate {
+        ChunkCoord coord;
+        std::array<const Chunk<StateT>*, 9> block;
+        std::array<SymmetryTransform, 9> view;
+    };
+    struct CandidateRef {
+        ChunkCoord coord;
+        int slot;
+        const Chunk<StateT>* chunk;
+        SymmetryTransform view;
+    };
+    std::vector<CandidateRef> candidate_refs;
+    std::vector<Candidate> candidates;             // Sorted by coordinate
+    ChunkMap recycled;                             // Chunks of the spare generation, by position
+    std::vector<typename ChunkMap::node_type> spare_nodes;
+    std::array<uint64_t, CHUNK_SIZE> touched;      // Sparse path: cells to evaluate, one row per word
+    std::vector<uint16_t> next_keys;               // Sparse path output
+    std::vector<StateT> next_values;
+    size_t next_churn = 0;                         // Cells changed by the last compute_*
+    // Scatter kernel: interior-sized count, center and mark buffers that are
+    // reset entry by entry, so a step costs O(population)
+    bool scatter_kernel = false;                   // Totalistic rule with default_state == StateT{}
+    std::vector<uint16_t> scatter_counts;
+    std::unique_ptr<StateT[]> scatter_center;
+    std::vector<uint8_t> scatter_mark;
+    std::vector<uint16_t> scatter_touched;
+    // Totalistic rules, tabulated by live-neighbor count: [0, n] for a default
+    // center, [n + 1, 2n + 1] for the other state when StateT is bool
+    std::unique_ptr<StateT[]> count_table;
+    int temporal_block = 1;                        // Generations per pass in run(), see set_temporal_blocking
+    std::unique_ptr<StateT[]> block_a;             // Blocked pass ping-pong buffers
+    std::unique_ptr<StateT[]> block_b;
+    
+    /**
+     * What the automaton has measured about one chunk position over time.
+     * hashes[g % HISTORY] is the content hash at generation g for
+     * g in (last_gen - HISTORY, last_gen]; generations after last_gen were empty.
+     */
+    struct RegionState {
+        static constexpr int HISTORY = 16;
+        std::array<uint64_t, HISTORY> hashes{};
+        int64_t last_gen = -1;
+        int64_t valid_from = 0;                    // Hashes before this generation are unknown (edited)
+        StepStrategy strategy = StepStrategy::DenseTile;
+        size_t churn = 0;
+        int period = 0;                            // Cycle being recorded or replayed, 0 if none
+        int recorded = 0;                          // Consecutive generations captured into cycle
+        bool verified = false;                     // A computed generation matched cycle cell for cell
+        std::vector<Chunk<StateT>> cycle;          // cycle[g % period] = chunk at generation g
+        std::vector<uint64_t> cycle_hashes;
+    };
+    static constexpr int MAX_PERIOD = RegionState::HISTORY / 2;
+    // Chunks flipping more cells than this per generation skip period detection
+    static constexpr size_t CHAOTIC_CHURN = CHUNK_SIZE * CHUNK_SIZE / 2;
+    // Sparse path while live cells * (neighborhood size + 1)^2 stays below this
+    static constexpr size_t SPARSE_WORK_BUDGET = 8 * CHUNK_SIZE * CHUNK_SIZE;
+    
+    std::unordered_map<ChunkCoord, RegionState, ChunkCoordHash> regions;
+    bool adaptive = true;
+    StrategyLogger strategy_logger;
+    StrategyStats last_stats;
+    int64_t history_start = 0;                     // No hashes are known before this generation
+    
+    // Chunks that repeated their content from one or two generations earlier
+    // for SETTLE_STEPS generations are frozen into shared blocks, deduplicated
+    // by content hash; later repeats reuse the block instead of writing a copy
+    static constexpr uint8_t SETTLE_STEPS = 4;
+    // Frozen chunks keep scratch buffers until steady this long
+    static constexpr uint8_t SCRATCH_STEADY_STEPS = 4 * SETTLE_STEPS;
+    std::unordered_map<uint64_t, std::weak_ptr<const FrozenCells<StateT>>> frozen_blocks;
+    size_t frozen_sweep_at = 64;                   // Drop expired entries once the table reaches this size
+    std::vector<uint16_t> freeze_keys;
+    std::vector<StateT> freeze_values;
+    
+    // Edits from other threads, applied by apply_queued_edits() grouped by chunk
+    struct QueuedEdit {
+        ChunkCoord chunk;
+        uint32_t order;                            // Keeps the last write to a cell last
+        uint16_t x, y;                             // Local coordinates
+        StateT state;
+    };
+    EditQueue<StateT> edit_queue;
+    std::vector<QueuedEdit> edit_batch;
+    
+    Symmetry symmetry = Symmetry::None;
     
     // Chunk coordinate from world coordinate
-    ChunkCoord get_chunk_coord(int32_t x, int32_t y) const;
+    static ChunkCoord get_chunk_coord(int32_t x, int32_t y);
     
     // Local coordinate within chunk
-    std::pair<int, int> get_local_coord(int32_t x, int32_t y) const;
+    static std::pair<int, int> get_local_coord(int32_t x, int32_t y);
+    
+    static StateT find_cell(const ChunkMap& chunks, Symmetry symmetry, int32_t x, int32_t y, StateT fallback);
+    static DensityRaster density_of(const Generation<StateT>& world, Symmetry symmetry, const CellRect& rect, int level);
+    static std::optional<BoundingBox> bounds_of(const Generation<StateT>& world, Symmetry symmetry);
     
     Chunk<StateT>* get_or_create_chunk(ChunkCoord coord);
-    std::vector<StateT> get_neighbors(int32_t x, int32_t y) const;
+    
+    StateT apply_count(StateT current, int live) const {
+        if constexpr (std::is_same_v<StateT, bool>) {
+            return count_table[(current != default_state) * (neighbor_offsets.size() + 1) + live];
+        } else if constexpr (CountRule<RuleT, StateT>) {
+            if (current == default_state) return count_table[live];
+            return rule.apply_count(current, live);
+        } else {
+            return current;    // Rules without apply_count() are never totalistic
+        }
+    }
+    
+    // Neighbor offsets as indices into a tile with rows of `stride` cells
+    const ptrdiff_t* gather_offsets_for(int stride) {
+        if (stride != gather_stride) {
+            for (size_t i = 0; i < neighbor_offsets.size(); ++i) {
+                const auto [dx, dy] = neighbor_offsets[i];
+                gather_offsets[i] = ptrdiff_t(dy) * stride + dx;
+            }
+            gather_stride = stride;
+        }
+        return gather_offsets.data();
+    }
+    
+    /**
+     * Next state of *cell under a rule that is not totalistic; its neighbors
+     * are cell[offsets[i]] for i < count, and cells with nothing alive
+     * around them stay `dead`. N is count when the calling kernel was
+     * specialized for it, 0 otherwise: functor rules then get a local array
+     * the compiler keeps in registers, and are evaluated without branching
+     * on liveness.
+     */
+    template<size_t N>
+    StateT apply_gathered(const StateT* cell, const ptrdiff_t* offsets, size_t count, StateT dead) {
+        bool any_live = *cell != dead;
+        if constexpr (std::is_same_v<RuleT, AnyRule<StateT>>) {
+            for (size_t i = 0; i < (N ? N : count); ++i) {
+                const StateT state = cell[offsets[i]];
+                neighbor_states[i] = state;
+                any_live |= state != dead;
+            }
+            return any_live ? rule.apply(*cell, neighbor_states) : dead;
+        } else if constexpr (NeighborRule<RuleT, StateT> && N > 0) {
+            StateT gathered[N];
+            for (size_t i = 0; i < N; ++i) {
+                gathered[i] = cell[offsets[i]];
+                any_live |= gathered[i] != dead;
+            }
+            const StateT next = rule.apply(*cell, std::span<const StateT>(gathered, N));
+            return any_live ? next : dead;
+        } else if constexpr (NeighborRule<RuleT, StateT>) {
+            StateT* gathered = neighbor_buffer.get();
+            for (size_t i = 0; i < count; ++i) {
+                gathered[i] = cell[offsets[i]];
+                any_live |= gathered[i] != dead;
+            }
+            return any_live ? rule.apply(*cell, std::span<const StateT>(gathered, count)) : dead;
+        } else {
+            return *cell;    // Rules without apply(current, neighbors) are always totalistic
+        }
+    }
+    
+    // Call kernel(std::integral_constant<size_t, N>{}) with N the neighborhood
+    // size if the kernels are specialized for it, 0 otherwise
+    template<typename Kernel>
+    decltype(auto) dispatch_gathered(Kernel&& kernel) const {
+        switch (neighbor_offsets.size()) {
+            case 4: return kernel(std::integral_constant<size_t, 4>{});
+            case 8: return kernel(std::integral_constant<size_t, 8>{});
+            default: return kernel(std::integral_constant<size_t, 0>{});
+        }
+    }
+    
+    // Fill out, a (CHUNK_SIZE + 2 * pad)^2 tile around the candidate, from its
+    // block (pad <= CHUNK_SIZE); returns the number of non-default cells
+    size_t load_tile(const Candidate& candidate, StateT* out, int pad);
+    // One generation of the size x size interior of in, a tile with a halo of
+    // `halo` cells, into out; returns its population and sets next_churn
+    size_t advance_tile(const StateT* in, int size, StateT* out);
+    // advance_tile for rules that are not totalistic
+    size_t advance_gathered(const StateT* in, int size, StateT* out);
+    // Step the loaded tile's interior into next_cells; returns its population
+    size_t compute_tile();
+    // Advance the tile in block_a by `generations` into next_cells, shrinking the
+    // valid region by one halo per generation; returns the final population
+    size_t compute_blocked_tile(int generations);
+    // Same result, evaluating only cells within reach of a live tile cell into
+    // next_keys / next_values
+    size_t compute_sparse_tile();
+    // Same output as compute_sparse_tile without a tile: live cells of the 3x3
+    // block scatter +1 into the counts of the cells around them. Returns the
+    // population and the live cells read in live_cells
+    size_t compute_scatter(const Candidate& candidate, size_t& live_cells);
+    
+    // Recorded hash of region at generation g, false if unknown
+    bool hash_at(const RegionState& region, int64_t g, uint64_t& hash) const;
+    bool hash_matches(ChunkCoord coord, int64_t gen_a, int64_t gen_b) const;
+    // Whether the 3x3 chunk block around coord repeated with period p for the
+    // `span` generations ending at gen
+    bool neighborhood_repeats(ChunkCoord coord, int period, int64_t gen, int span) const;
+    static void record_hash(RegionState& region, int64_t gen, uint64_t hash);
+    // Forget periodicity around a chunk edited outside of step()
+    void invalidate_region(ChunkCoord coord);
+    // Forget all hashes, e.g. after generations were skipped over
+    void reset_history();
+    
+    // Spare generation with its chunks moved to recycled, and the candidates around current
+    Generation<StateT>* begin_step();
+    // Insert a chunk for coord into chunks, reusing a recycled node when there is one
+    Chunk<StateT>* emplace_chunk(ChunkMap& chunks, ChunkCoord coord);
+    // Move chunk into a shared frozen block, reusing an identical one
+    void freeze_chunk(Chunk<StateT>& chunk);
+    void finish_step(Generation<StateT>* next, int generations);
+    // Advance every chunk by `generations` (generations * halo <= CHUNK_SIZE) in one pass
+    void step_blocked(int generations);
+    
+    // Release every retired, unpinned generation but the most recent, which
+    // is returned (nullptr if there is none)
+    Generation<StateT>* reclaim_retired();
+    // Pick a pool entry that is neither current, published nor pinned
+    Generation<StateT>* acquire_spare_world();
+    // Shrink the buckets of map when it holds far fewer than they were sized for
+    static void shrink_index(ChunkMap& map, size_t entries);
+    static void copy_world(const Generation<StateT>& from, Generation<StateT>& to);
+    // Copy-on-write: edits never touch a generation readers can see
+    void make_current_writable();
     
 public:
+    using Snapshot = GenerationSnapshot<StateT>;
+    
+    /**
+     * Throws std::invalid_argument if the neighborhood radius is outside
+     * [1, CHUNK_SIZE], or if the rule claims a kind it cannot evaluate: a
+     * totalistic rule without apply_count(), or any other rule without
+     * apply(current, neighbors).
+     */
+    explicit CellularAutomaton(RuleT r, StateT default_val = StateT{});
     CellularAutomaton(std::unique_ptr<Rule<StateT>> r, StateT default_val = StateT{})
-        : rule(std::move(r)), default_state(default_val) {}
+        requires std::same_as<RuleT, AnyRule<StateT>>
+        : CellularAutomaton(RuleT(std::move(r)), default_val) {}
+    
+    const RuleT& get_rule() const { return rule; }
     
     StateT get_cell(int32_t x, int32_t y) const;
     void set_cell(int32_t x, int32_t y, StateT state);
+    // Bulk write into the chunk at chunk coordinates (chunk_x, chunk_y)
+    void stamp_chunk_bits(int32_t chunk_x, int32_t chunk_y, const ChunkBits& rows, StateT state);
+    
+    /**
+     * Queue edits from any thread, including while another thread steps. They
+     * take effect at the next generation boundary: the start of step(), or of
+     * the next pass when run() uses temporal blocking. Enqueuing is lock-free.
+     *
+     * @param cells Pattern cells relative to (x, y), applied in order
+     */
+    void enqueue_cell(int32_t x, int32_t y, StateT state) { edit_queue.push(x, y, state); }
+    void enqueue_pattern(int32_t x, int32_t y, std::vector<CellEdit<StateT>> cells) {
+        edit_queue.push_pattern(x, y, std::move(cells));
+    }
+    // Apply queued edits now, from the stepping thread; returns the commands applied
+    size_t apply_queued_edits();
+    
     void step();
     void run(int64_t iterations);
     
-    int64_t get_generation() const { return generation; }
-    size_t get_active_chunks() const { return chunks.size(); }
+    // Make edits since the last step visible to snapshot(); step() publishes on its own
+    void publish();
+    /**
+     * Pin the latest published generation; lock-free and callable from any
+     * thread. Memory of a generation whose last snapshot was released is
+     * reclaimed at the next publish() or step().
+     */
+    Snapshot snapshot() const;
+    
+    int64_t get_generation() const { return current->number; }
+    size_t get_active_chunks() const { return current->chunks.size(); }
+    
+    /**
+     * Live-cell counts over rect at 2^level x 2^level cells per pixel.
+     * Levels >= log2(CHUNK_SIZE) read only the density pyramid, one lookup per
+     * pixel; finer levels bin the live cells of the chunks under rect.
+     * Throws std::out_of_range for levels beyond the pyramid.
+     */
+    DensityRaster query_density(const CellRect& rect, int level) const;
+    // Exact bounds of the live cells; only the chunks on the edges are scanned
+    std::optional<BoundingBox> bounding_box() const;
+    MemoryUsage memory_usage() const;
+    
+    /**
+     * Per-chunk strategy selection. When enabled (the default) each chunk is
+     * stepped with the sparse list path, the dense tile kernel or memoized
+     * replay depending on the live cells around it and its measured
+     * periodicity; disabled, every chunk uses the dense tile kernel. Sparse
+     * and dense chunks alike are checked for periods, except chunks whose
+     * churn exceeds CHAOTIC_CHURN cells per generation. Replay still
+     * advances one generation per step(), copying the next recorded phase;
+     * it does not skip ahead by whole periods.
+     *
+     * Periods are detected from 64-bit content hashes. Replay starts only
+     * after a computed generation of the chunk equals its recorded phase
+     * cell for cell, but its neighbors are still matched by hash alone, so
+     * a hash collision around a replayed chunk can go unnoticed.
+     */
+    void set_adaptive(bool enabled);
+    // Called for every chunk whose strategy changes; pass {} to stop logging
+    void set_strategy_logger(StrategyLogger logger) { strategy_logger = std::move(logger); }
+    const StrategyStats& get_strategy_stats() const { return last_stats; }
+    
+    /**
+     * Temporal blocking for run(). Each pass loads every chunk with a halo of
+     * generations * radius cells into scratch, advances it that many
+     * generations in place and writes back only the chunk, so chunk memory is
+     * swept once per pass instead of once per generation. Intermediate
+     * generations are never published and bypass per-chunk strategies.
+     *
+     * @param generations Generations per pass; 1 disables blocking, 0 picks the
+     *                    largest depth whose scratch tiles fit in L2. Clamped so
+     *                    that generations * radius <= CHUNK_SIZE.
+     */
+    void set_temporal_blocking(int generations);
+    int get_temporal_blocking() const { return temporal_block; }
+    
+    /**
+     * Declare the universe symmetric under a group. Only the fundamental
+     * domain is stored and stepped; neighbors across an axis are read from the
+     * stored chunks through the group, and get_cell(), snapshots, density and
+     * bounds report the whole universe. set_cell() and the other edits write
+     * a cell's whole orbit.
+     *
+     * Must be called before any cell is set. Throws std::invalid_argument
+     * unless the rule is totalistic and its neighborhood maps onto itself
+     * under the group (the hexagonal neighborhood only allows C2).
+     */
+    void set_symmetry(Symmetry group);
+    Symmetry get_symmetry() const { return symmetry; }
 };
 
+template<typename StateT, typename RuleT>
+void print_pattern(const CellularAutomaton<StateT, RuleT>& ca, int start_x, int start_y, int width, int height);
+
 template<typename StateT>
-void print_pattern(const CellularAutomaton<StateT>& ca, int start_x, int start_y, int width, int height);
+void print_pattern(const GenerationSnapshot<StateT>& snapshot, int start_x, int start_y, int width, int height);
+
+// Compiled into the cell_automaton library; see cellular_automaton_impl.hpp
+extern template class FrozenCells<bool>;
+extern template class FrozenCells<int>;
+extern template class FrozenCells<uint8_t>;
+extern template class Chunk<bool>;
+extern template class Chunk<int>;
+extern template class Chunk<uint8_t>;
+extern template class GenerationSnapshot<bool>;
+extern template class GenerationSnapshot<int>;
+extern template class GenerationSnapshot<uint8_t>;
+extern template class CellularAutomaton<bool>;
+extern template class CellularAutomaton<int>;
+extern template class CellularAutomaton<uint8_t>;
 
 #endif // CELLULAR_AUTOMATON_HPP
\ No newline at end of file
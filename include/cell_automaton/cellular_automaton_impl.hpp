@@ -0,0 +1,1813 @@
+#ifndef CELLULAR_AUTOMATON_IMPL_HPP
+#define CELLULAR_AUTOMATON_IMPL_HPP
+
+// Member definitions of the automaton templates. The library instantiates
+// them for AnyRule over bool, int and uint8_t; include this header to
+// instantiate CellularAutomaton with another rule type or state.
+#include "cell_automaton/cellular_automaton.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <climits>
+#include <string>
+#include <unordered_set>
+// #include <execution>  // Not available on all platforms
+
+// ============================================================================
+// FrozenCells Implementation
+// ============================================================================
+
+template<typename StateT>
+FrozenCells<StateT>::FrozenCells(const std::vector<uint16_t>& cell_keys, const std::vector<StateT>& cell_values,
+                                 uint64_t content_hash)
+    : population(cell_keys.size()), hash(content_hash) {
+    const size_t bitmap_bytes = CHUNK_SIZE * sizeof(uint64_t) + (STORES_VALUES ? CHUNK_SIZE * sizeof(uint16_t) : 0);
+    if (cell_keys.size() * sizeof(uint16_t) < bitmap_bytes) {
+        keys.assign(cell_keys.begin(), cell_keys.end());
+    } else {
+        rows.assign(CHUNK_SIZE, 0);
+        for (uint16_t key : cell_keys) {
+            rows[key / CHUNK_SIZE] |= uint64_t(1) << (key % CHUNK_SIZE);
+        }
+        if constexpr (STORES_VALUES) {
+            row_start.resize(CHUNK_SIZE);
+            uint16_t before = 0;
+            for (size_t y = 0; y < CHUNK_SIZE; ++y) {
+                row_start[y] = before;
+                before += static_cast<uint16_t>(std::popcount(rows[y]));
+            }
+        }
+    }
+    if constexpr (STORES_VALUES) {
+        values.assign(cell_values.begin(), cell_values.end());
+    }
+}
+
+template<typename StateT>
+StateT FrozenCells<StateT>::get(uint16_t key) const {
+    if (rows.empty()) {
+        auto it = std::lower_bound(keys.begin(), keys.end(), key);
+        return (it != keys.end() && *it == key) ? value_at(it - keys.begin()) : StateT{};
+    }
+    const uint64_t row = rows[key / CHUNK_SIZE];
+    const uint64_t bit = uint64_t(1) << (key % CHUNK_SIZE);
+    if (!(row & bit)) return StateT{};
+    if constexpr (STORES_VALUES) {
+        return values[row_start[key / CHUNK_SIZE] + std::popcount(row & (bit - 1))];
+    } else {
+        return true;
+    }
+}
+
+template<typename StateT>
+bool FrozenCells<StateT>::matches(const std::vector<uint16_t>& cell_keys, const std::vector<StateT>& cell_values) const {
+    if (cell_keys.size() != population) return false;
+    
+    size_t i = 0;
+    bool same = true;
+    for_each_in(0, 0, CHUNK_SIZE, CHUNK_SIZE, [&](int x, int y, StateT state) {
+        same = same && cell_keys[i] == y * CHUNK_SIZE + x && cell_values[i] == state;
+        ++i;
+    });
+    return same;
+}
+
+template<typename StateT>
+bool FrozenCells<StateT>::matches(const StateT* cells, size_t live) const {
+    if (live != population) return false;
+    
+    // Equal populations: matching every frozen cell leaves the rest default
+    bool same = true;
+    for_each_in(0, 0, CHUNK_SIZE, CHUNK_SIZE, [&](int x, int y, StateT state) {
+        same = same && cells[y * CHUNK_SIZE + x] == state;
+    });
+    return same;
+}
+
+template<typename StateT>
+size_t FrozenCells<StateT>::memory_usage() const {
+    return sizeof(FrozenCells<StateT>) + keys.capacity() * sizeof(uint16_t) + rows.capacity() * sizeof(uint64_t)
+         + row_start.capacity() * sizeof(uint16_t) + (STORES_VALUES ? values.capacity() * sizeof(StateT) : 0);
+}
+
+// ============================================================================
+// Chunk Implementation
+// ============================================================================
+
+template<typename StateT>
+void Chunk<StateT>::release_buffers() {
+    dense_data.reset();
+    std::vector<uint16_t>().swap(sparse_keys);
+    std::vector<StateT>().swap(sparse_values);
+    is_dense = false;
+}
+
+template<typename StateT>
+void Chunk<StateT>::freeze(Frozen block) {
+    population = static_cast<uint16_t>(block->get_population());
+    frozen = std::move(block);
+    release_buffers();
+}
+
+template<typename StateT>
+void Chunk<StateT>::thaw() {
+    if (!frozen) return;
+    
+    // Same threshold set_cell would have converted at
+    if (population > DENSITY_THRESHOLD * CHUNK_SIZE * CHUNK_SIZE) {
+        if (!dense_data) dense_data = std::make_unique<DenseStorage>();
+        dense_data->fill(StateT{});
+        frozen->for_each_in(0, 0, CHUNK_SIZE, CHUNK_SIZE, [this](int x, int y, StateT state) {
+            (*dense_data)[pack_local(x, y)] = state;
+        });
+        is_dense = true;
+    } else {
+        dense_data.reset();
+        sparse_keys.reserve(population);
+        sparse_values.reserve(population);
+        collect(sparse_keys, sparse_values);
+    }
+    frozen.reset();
+}
+
+template<typename StateT>
+void Chunk<StateT>::trim() {
+    if (frozen) release_buffers();
+}
+
+template<typename StateT>
+void Chunk<StateT>::collect(std::vector<uint16_t>& keys, std::vector<StateT>& values) const {
+    for_each_live([&](int x, int y, StateT state) {
+        keys.push_back(pack_local(x, y));
+        values.push_back(state);
+    });
+}
+
+template<typename StateT>
+void Chunk<StateT>::convert_to_dense() {
+    thaw();
+    if (is_dense) return;
+    
+    // Initialize dense array with default values
+    if (!dense_data) dense_data = std::make_unique<DenseStorage>();
+    dense_data->fill(StateT{});
+    
+    // Copy sparse data to dense
+    for (size_t i = 0; i < sparse_keys.size(); ++i) {
+        (*dense_data)[sparse_keys[i]] = sparse_values[i];
+    }
+    
+    // Release the sparse buffers entirely; clear() would keep their capacity
+    std::vector<uint16_t>().swap(sparse_keys);
+    std::vector<StateT>().swap(sparse_values);
+    is_dense = true;
+}
+
+template<typename StateT>
+void Chunk<StateT>::convert_to_sparse() {
+    thaw();
+    if (!is_dense) return;
+    
+    sparse_keys.clear();
+    sparse_values.clear();
+    sparse_keys.reserve(population);
+    sparse_values.reserve(population);
+    
+    // Only store non-default states, in ascending key order
+    for (uint16_t key = 0; key < CHUNK_SIZE * CHUNK_SIZE; ++key) {
+        StateT state = (*dense_data)[key];
+        if (state != StateT{}) {
+            sparse_keys.push_back(key);
+            sparse_values.push_back(state);
+        }
+    }
+    
+    dense_data.reset();
+    is_dense = false;
+}
+
+template<typename StateT>
+StateT Chunk<StateT>::get_cell(int x, int y) const {
+    if (x < 0 || x >= CHUNK_SIZE || y < 0 || y >= CHUNK_SIZE) {
+        return StateT{};  // Out of bounds
+    }
+    
+    uint16_t key = pack_local(x, y);
+    if (frozen) {
+        return frozen->get(key);
+    } else if (is_dense) {
+        return (*dense_data)[key];
+    } else {
+        auto it = std::lower_bound(sparse_keys.begin(), sparse_keys.end(), key);
+        return (it != sparse_keys.end() && *it == key) ? sparse_values[it - sparse_keys.begin()] : StateT{};
+    }
+}
+
+template<typename StateT>
+void Chunk<StateT>::store(uint16_t key, StateT state) {
+    if (is_dense) {
+        StateT& slot = (*dense_data)[key];
+        population += (state != StateT{}) - (slot != StateT{});
+        slot = state;
+        return;
+    }
+    
+    auto it = std::lower_bound(sparse_keys.begin(), sparse_keys.end(), key);
+    size_t index = it - sparse_keys.begin();
+    bool present = it != sparse_keys.end() && *it == key;
+    
+    if (state != StateT{}) {
+        if (present) {
+            sparse_values[index] = state;
+        } else {
+            sparse_keys.insert(it, key);
+            sparse_values.insert(sparse_values.begin() + index, state);
+            ++population;
+        }
+    } else if (present) {
+        sparse_keys.erase(it);
+        sparse_values.erase(sparse_values.begin() + index);
+        --population;
+    }
+}
+
+template<typename StateT>
+void Chunk<StateT>::set_cell(int x, int y, StateT state) {
+    if (x < 0 || x >= CHUNK_SIZE || y < 0 || y >= CHUNK_SIZE) {
+        return;  // Out of bounds
+    }
+    
+    thaw();
+    store(pack_local(x, y), state);
+    
+    if (is_dense) {
+        // Consider converting to sparse if density drops
+        if (should_be_sparse()) {
+            convert_to_sparse();
+        }
+    } else {
+        // Consider converting to dense if density increases
+        if (should_be_dense()) {
+            convert_to_dense();
+        }
+    }
+}
+
+template<typename StateT>
+void Chunk<StateT>::stamp_bits(const ChunkBits& rows, StateT state) {
+    size_t incoming = 0;
+    for (uint64_t row : rows) {
+        incoming += std::popcount(row);
+    }
+    if (incoming == 0) return;
+    
+    thaw();
+    // Decide storage up front instead of re-checking density per cell
+    if (!is_dense && state != StateT{} &&
+        population + incoming > DENSITY_THRESHOLD * CHUNK_SIZE * CHUNK_SIZE) {
+        convert_to_dense();
+    }
+    
+    for (int y = 0; y < static_cast<int>(CHUNK_SIZE); ++y) {
+        uint64_t row = rows[y];
+        while (row) {
+            int x = std::countr_zero(row);
+            row &= row - 1;
+            store(pack_local(x, y), state);
+        }
+    }
+    
+    if (is_dense && should_be_sparse()) {
+        convert_to_sparse();
+    }
+}
+
+template<typename StateT>
+void Chunk<StateT>::assign_cells(const StateT* cells, size_t live_cells, bool was_dense) {
+    const double density = static_cast<double>(live_cells) / (CHUNK_SIZE * CHUNK_SIZE);
+    const bool want_dense = was_dense ? density > DENSITY_THRESHOLD * 0.5 : density > DENSITY_THRESHOLD;
+    population = static_cast<uint16_t>(live_cells);
+    frozen.reset();
+    
+    if (want_dense) {
+        if (!dense_data) dense_data = std::make_unique<DenseStorage>();
+        std::copy(cells, cells + CHUNK_SIZE * CHUNK_SIZE, dense_data->begin());
+        if (!is_dense) {
+            std::vector<uint16_t>().swap(sparse_keys);
+            std::vector<StateT>().swap(sparse_values);
+        }
+        is_dense = true;
+        return;
+    }
+    
+    dense_data.reset();
+    sparse_keys.clear();
+    sparse_values.clear();
+    sparse_keys.reserve(live_cells);
+    sparse_values.reserve(live_cells);
+    for (uint16_t key = 0; key < CHUNK_SIZE * CHUNK_SIZE; ++key) {
+        if (cells[key] != StateT{}) {
+            sparse_keys.push_back(key);
+            sparse_values.push_back(cells[key]);
+        }
+    }
+    is_dense = false;
+}
+
+template<typename StateT>
+void Chunk<StateT>::assign_sparse(const std::vector<uint16_t>& keys, const std::vector<StateT>& values, bool was_dense) {
+    const size_t count = keys.size();
+    const double density = static_cast<double>(count) / (CHUNK_SIZE * CHUNK_SIZE);
+    const bool want_dense = was_dense ? density > DENSITY_THRESHOLD * 0.5 : density > DENSITY_THRESHOLD;
+    population = static_cast<uint16_t>(count);
+    frozen.reset();
+    
+    if (want_dense) {
+        if (!dense_data) dense_data = std::make_unique<DenseStorage>();
+        dense_data->fill(StateT{});
+        for (size_t i = 0; i < count; ++i) {
+            (*dense_data)[keys[i]] = values[i];
+        }
+        if (!is_dense) {
+            std::vector<uint16_t>().swap(sparse_keys);
+            std::vector<StateT>().swap(sparse_values);
+        }
+        is_dense = true;
+        return;
+    }
+    
+    dense_data.reset();
+    sparse_keys = keys;
+    sparse_values = values;
+    is_dense = false;
+}
+
+template<typename StateT>
+uint64_t Chunk<StateT>::content_hash() const {
+    if (frozen) return frozen->content_hash();
+    
+    uint64_t hash = 0;
+    for_each_live([&](int x, int y, StateT state) {
+        uint64_t v = (uint64_t(y * CHUNK_SIZE + x) << 32) ^ static_cast<uint64_t>(state);
+        v *= 0x9E3779B97F4A7C15ULL;
+        v ^= v >> 32;
+        hash = (hash ^ v) * 0xBF58476D1CE4E5B9ULL + 1;
+    });
+    return hash;
+}
+
+template<typename StateT>
+bool Chunk<StateT>::same_cells(const Chunk& other) const {
+    if (population != other.population) return false;
+    if (frozen && frozen == other.frozen) return true;
+    
+    // Equal populations: matching every cell of this chunk leaves the rest default
+    bool same = true;
+    for_each_live([&](int x, int y, StateT state) {
+        same = same && other.get_cell(x, y) == state;
+    });
+    return same;
+}
+
+template<typename StateT>
+size_t Chunk<StateT>::copy_region(int x0, int y0, int w, int h, StateT* out, size_t out_stride) const {
+    size_t copied = 0;
+    if (frozen) {
+        frozen->for_each_in(x0, y0, w, h, [&](int x, int y, StateT state) {
+            out[(y - y0) * out_stride + (x - x0)] = state;
+            ++copied;
+        });
+        return copied;
+    }
+    if (is_dense) {
+        for (int y = 0; y < h; ++y) {
+            const StateT* row = dense_data->data() + (y0 + y) * CHUNK_SIZE + x0;
+            StateT* dst = out + y * out_stride;
+            for (int x = 0; x < w; ++x) {
+                dst[x] = row[x];
+                copied += row[x] != StateT{};
+            }
+        }
+        return copied;
+    }
+    
+    const uint16_t first = pack_local(x0, y0);
+    const uint16_t last = pack_local(0, y0 + h);
+    for (auto it = std::lower_bound(sparse_keys.begin(), sparse_keys.end(), first);
+         it != sparse_keys.end() && *it < last; ++it) {
+        const int x = *it % CHUNK_SIZE;
+        const int y = *it / CHUNK_SIZE;
+        if (x < x0 || x >= x0 + w) continue;
+        out[(y - y0) * out_stride + (x - x0)] = sparse_values[it - sparse_keys.begin()];
+        ++copied;
+    }
+    return copied;
+}
+
+template<typename StateT>
+bool Chunk<StateT>::is_empty() const {
+    return population == 0;
+}
+
+template<typename StateT>
+bool Chunk<StateT>::should_be_dense() const {
+    if (is_dense) return true;
+    
+    double density = static_cast<double>(population) / (CHUNK_SIZE * CHUNK_SIZE);
+    return density > DENSITY_THRESHOLD;
+}
+
+template<typename StateT>
+bool Chunk<StateT>::should_be_sparse() const {
+    if (!is_dense) return true;
+    
+    double density = static_cast<double>(population) / (CHUNK_SIZE * CHUNK_SIZE);
+    return density <= DENSITY_THRESHOLD * 0.5;  // Hysteresis to prevent thrashing
+}
+
+template<typename StateT>
+Chunk<StateT>::Chunk(const Chunk& other) {
+    *this = other;
+}
+
+template<typename StateT>
+Chunk<StateT>& Chunk<StateT>::operator=(const Chunk& other) {
+    if (this == &other) return *this;
+    
+    // Reuse whichever buffers this chunk already owns; a frozen block is shared
+    is_dense = other.is_dense;
+    population = other.population;
+    steady = other.steady;
+    frozen = other.frozen;
+    if (frozen) {
+        // Emptied buffers stay as scratch for the next thaw or assignment
+        sparse_keys.clear();
+        sparse_values.clear();
+    } else if (other.is_dense) {
+        if (!dense_data) dense_data = std::make_unique<DenseStorage>();
+        *dense_data = *other.dense_data;
+        sparse_keys.clear();
+        sparse_values.clear();
+    } else {
+        dense_data.reset();
+        sparse_keys = other.sparse_keys;
+        sparse_values = other.sparse_values;
+    }
+    return *this;
+}
+
+template<typename StateT>
+size_t Chunk<StateT>::memory_usage() const {
+    // Buffers kept as scratch count too
+    size_t bytes = sizeof(Chunk<StateT>) + sparse_keys.capacity() * sizeof(uint16_t)
+                 + sparse_values.capacity() * sizeof(StateT);
+    if (dense_data) {
+        bytes += sizeof(DenseStorage);
+    }
+    return bytes;
+}
+
+// ============================================================================
+// GenerationSnapshot Implementation
+// ============================================================================
+
+template<typename StateT>
+GenerationSnapshot<StateT>& GenerationSnapshot<StateT>::operator=(GenerationSnapshot&& other) noexcept {
+    if (this != &other) {
+        if (world) world->readers.fetch_sub(1, std::memory_order_release);
+        world = std::exchange(other.world, nullptr);
+        default_state = other.default_state;
+        symmetry = other.symmetry;
+    }
+    return *this;
+}
+
+template<typename StateT>
+GenerationSnapshot<StateT>::~GenerationSnapshot() {
+    if (world) world->readers.fetch_sub(1, std::memory_order_release);
+}
+
+template<typename StateT>
+StateT GenerationSnapshot<StateT>::get_cell(int32_t x, int32_t y) const {
+    return CellularAutomaton<StateT>::find_cell(world->chunks, symmetry, x, y, default_state);
+}
+
+template<typename StateT>
+DensityRaster GenerationSnapshot<StateT>::query_density(const CellRect& rect, int level) const {
+    return CellularAutomaton<StateT>::density_of(*world, symmetry, rect, level);
+}
+
+template<typename StateT>
+std::optional<BoundingBox> GenerationSnapshot<StateT>::bounding_box() const {
+    return CellularAutomaton<StateT>::bounds_of(*world, symmetry);
+}
+
+// ============================================================================
+// CellularAutomaton Implementation
+// ============================================================================
+
+template<typename StateT, CellRule<StateT> RuleT>
+CellularAutomaton<StateT, RuleT>::CellularAutomaton(RuleT r, StateT default_val)
+    : rule(std::move(r)), default_state(default_val) {
+    neighborhood = rule.neighborhood();
+    if (neighborhood.radius < 1 || neighborhood.radius > static_cast<int>(CHUNK_SIZE)) {
+        throw std::invalid_argument("CellularAutomaton: neighborhood radius must be in [1, CHUNK_SIZE]");
+    }
+    totalistic = is_totalistic_rule<StateT>(rule);
+    if (totalistic && !CountRule<RuleT, StateT>) {
+        throw std::invalid_argument("CellularAutomaton: a totalistic rule must provide apply_count()");
+    }
+    if (!totalistic && !NeighborRule<RuleT, StateT> && !std::is_same_v<RuleT, AnyRule<StateT>>) {
+        throw std::invalid_argument("CellularAutomaton: a rule that is not totalistic must provide apply(current, neighbors)");
+    }
+    neighbor_offsets = neighborhood.offsets();
+    halo = neighborhood.radius;
+    
+    // Horizontal extent of each neighborhood row, center included
+    row_spans.assign(2 * halo + 1, {0, 0});
+    for (const auto& [dx, dy] : neighbor_offsets) {
+        auto& [lo, hi] = row_spans[dy + halo];
+        lo = std::min(lo, dx);
+        hi = std::max(hi, dx);
+    }
+    tile_size = static_cast<int>(CHUNK_SIZE) + 2 * halo;
+    
+    const size_t tile_cells = size_t(tile_size) * tile_size;
+    tile = std::make_unique<StateT[]>(tile_cells);
+    next_cells = std::make_unique<StateT[]>(CHUNK_SIZE * CHUNK_SIZE);
+    live_mask.resize(tile_cells);
+    neighbor_counts.resize(CHUNK_SIZE * CHUNK_SIZE);
+    neighbor_states.resize(neighbor_offsets.size());
+    neighbor_buffer = std::make_unique<StateT[]>(neighbor_offsets.size());
+    gather_offsets.resize(neighbor_offsets.size());
+    
+    scatter_kernel = totalistic && default_state == StateT{};
+    if (scatter_kernel) {
+        scatter_counts.assign(CHUNK_SIZE * CHUNK_SIZE, 0);
+        scatter_center = std::make_unique<StateT[]>(CHUNK_SIZE * CHUNK_SIZE);
+        std::fill(scatter_center.get(), scatter_center.get() + CHUNK_SIZE * CHUNK_SIZE, default_state);
+        scatter_mark.assign(CHUNK_SIZE * CHUNK_SIZE, 0);
+        scatter_touched.reserve(CHUNK_SIZE * CHUNK_SIZE);
+    }
+    
+    if constexpr (CountRule<RuleT, StateT>) {
+        if (totalistic) {
+            // A default cell with nothing alive around it stays default
+            const size_t counts = neighbor_offsets.size() + 1;
+            count_table = std::make_unique<StateT[]>(2 * counts);
+            for (size_t live = 0; live < counts; ++live) {
+                count_table[live] = live == 0 ? default_state : rule.apply_count(default_state, int(live));
+                if constexpr (std::is_same_v<StateT, bool>) {
+                    count_table[counts + live] = rule.apply_count(!default_state, int(live));
+                }
+            }
+        }
+    }
+    
+    worlds.push_back(std::make_unique<Generation<StateT>>());
+    current = worlds.back().get();
+    published.store(current);
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+typename CellularAutomaton<StateT, RuleT>::ChunkCoord 
+CellularAutomaton<StateT, RuleT>::get_chunk_coord(int32_t x, int32_t y) {
+    // Floor division; CHUNK_SIZE is unsigned so keep the arithmetic signed
+    constexpr int32_t size = static_cast<int32_t>(CHUNK_SIZE);
+    return {(x >= 0 ? x : x - size + 1) / size,
+            (y >= 0 ? y : y - size + 1) / size};
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+std::pair<int, int> CellularAutomaton<StateT, RuleT>::get_local_coord(int32_t x, int32_t y) {
+    constexpr int32_t size = static_cast<int32_t>(CHUNK_SIZE);
+    int lx = x % size;
+    int ly = y % size;
+    if (lx < 0) lx += size;
+    if (ly < 0) ly += size;
+    return {lx, ly};
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+StateT CellularAutomaton<StateT, RuleT>::find_cell(const ChunkMap& chunks, Symmetry symmetry, int32_t x, int32_t y, StateT fallback) {
+    std::tie(x, y) = fundamental_image(symmetry, x, y);
+    auto it = chunks.find(get_chunk_coord(x, y));
+    
+    if (it == chunks.end()) {
+        return fallback;
+    }
+    
+    auto [lx, ly] = get_local_coord(x, y);
+    return it->second->get_cell(lx, ly);
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+Generation<StateT>* CellularAutomaton<StateT, RuleT>::reclaim_retired() {
+    Generation<StateT>* visible = published.load();
+    Generation<StateT>* spare = nullptr;
+    
+    // Keep the most recent free generation for the double buffer: the next
+    // step recycles its chunks
+    for (auto& world : worlds) {
+        Generation<StateT>* w = world.get();
+        if (w == current || w == visible || w->readers.load() != 0) continue;
+        if (!spare || w->number > spare->number) spare = w;
+    }
+    
+    // Generations held by readers earlier: release their chunks and pyramid
+    for (auto& world : worlds) {
+        Generation<StateT>* w = world.get();
+        if (w == current || w == visible || w == spare || w->readers.load() != 0) continue;
+        ChunkMap().swap(w->chunks);
+        w->pyramid.release();
+    }
+    return spare;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+Generation<StateT>* CellularAutomaton<StateT, RuleT>::acquire_spare_world() {
+    if (Generation<StateT>* spare = reclaim_retired()) return spare;
+    
+    worlds.push_back(std::make_unique<Generation<StateT>>());
+    return worlds.back().get();
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::shrink_index(ChunkMap& map, size_t entries) {
+    // Bucket arrays never shrink on their own; after a transient peak keep
+    // only what `entries` need
+    if (map.bucket_count() > 64 && entries * 8 < map.bucket_count()) {
+        map.rehash(entries);
+    }
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::copy_world(const Generation<StateT>& from, Generation<StateT>& to) {
+    for (auto it = to.chunks.begin(); it != to.chunks.end();) {
+        if (from.chunks.count(it->first) == 0) {
+            it = to.chunks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    for (const auto& [coord, chunk] : from.chunks) {
+        auto& slot = to.chunks[coord];
+        if (slot) {
+            *slot = *chunk;
+        } else {
+            slot = std::make_unique<Chunk<StateT>>(*chunk);
+        }
+    }
+    to.pyramid = from.pyramid;
+    to.number = from.number;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::make_current_writable() {
+    if (published.load() != current) return;
+    
+    Generation<StateT>* copy = acquire_spare_world();
+    copy_world(*current, *copy);
+    current = copy;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::publish() {
+    published.store(current);
+    reclaim_retired();
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+typename CellularAutomaton<StateT, RuleT>::Snapshot CellularAutomaton<StateT, RuleT>::snapshot() const {
+    for (;;) {
+        Generation<StateT>* w = published.load();
+        w->readers.fetch_add(1);
+        // The writer may have recycled w between the two loads; only a
+        // generation that is still published after pinning is safe to read
+        if (published.load() == w) {
+            return Snapshot(w, default_state, symmetry);
+        }
+        w->readers.fetch_sub(1);
+    }
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+Chunk<StateT>* CellularAutomaton<StateT, RuleT>::get_or_create_chunk(ChunkCoord coord) {
+    auto& chunks = current->chunks;
+    auto it = chunks.find(coord);
+    if (it != chunks.end()) {
+        return it->second.get();
+    }
+    
+    auto new_chunk = std::make_unique<Chunk<StateT>>();
+    auto* ptr = new_chunk.get();
+    chunks[coord] = std::move(new_chunk);
+    return ptr;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+StateT CellularAutomaton<StateT, RuleT>::get_cell(int32_t x, int32_t y) const {
+    return find_cell(current->chunks, symmetry, x, y, default_state);
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::set_cell(int32_t x, int32_t y, StateT state) {
+    make_current_writable();
+    std::tie(x, y) = fundamental_image(symmetry, x, y);
+    auto& chunks = current->chunks;
+    
+    if (state == default_state) {
+        // Setting to default - only need to clear if chunk exists
+        ChunkCoord chunk_coord = get_chunk_coord(x, y);
+        auto it = chunks.find(chunk_coord);
+        if (it != chunks.end()) {
+            auto [lx, ly] = get_local_coord(x, y);
+            size_t before = it->second->get_population();
+            it->second->set_cell(lx, ly, state);
+            current->pyramid.add(chunk_coord.first, chunk_coord.second,
+                                 int64_t(it->second->get_population()) - int64_t(before));
+            invalidate_region(chunk_coord);
+        }
+    } else {
+        // Setting to non-default - create chunk if needed
+        ChunkCoord chunk_coord = get_chunk_coord(x, y);
+        Chunk<StateT>* chunk = get_or_create_chunk(chunk_coord);
+        auto [lx, ly] = get_local_coord(x, y);
+        size_t before = chunk->get_population();
+        chunk->set_cell(lx, ly, state);
+        current->pyramid.add(chunk_coord.first, chunk_coord.second,
+                             int64_t(chunk->get_population()) - int64_t(before));
+        invalidate_region(chunk_coord);
+    }
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::stamp_chunk_bits(int32_t chunk_x, int32_t chunk_y, const ChunkBits& rows, StateT state) {
+    if (!in_fundamental_domain(symmetry, chunk_x, chunk_y)) {
+        // Stamp the image of the chunk instead
+        const SymmetryTransform g = to_fundamental_domain(symmetry, chunk_x, chunk_y);
+        constexpr int last = static_cast<int>(CHUNK_SIZE) - 1;
+        ChunkBits image{};
+        for (int ly = 0; ly < static_cast<int>(CHUNK_SIZE); ++ly) {
+            for (uint64_t bits = rows[ly]; bits; bits &= bits - 1) {
+                auto [ix, iy] = g.apply(std::countr_zero(bits), ly, last);
+                image[iy] |= uint64_t(1) << ix;
+            }
+        }
+        auto [image_x, image_y] = g.apply(chunk_x, chunk_y, -1);
+        stamp_chunk_bits(image_x, image_y, image, state);
+        return;
+    }
+    
+    make_current_writable();
+    auto& chunks = current->chunks;
+    
+    Chunk<StateT>* chunk = nullptr;
+    if (state == default_state) {
+        auto it = chunks.find({chunk_x, chunk_y});
+        if (it == chunks.end()) return;
+        chunk = it->second.get();
+    } else {
+        chunk = get_or_create_chunk({chunk_x, chunk_y});
+    }
+    
+    size_t before = chunk->get_population();
+    chunk->stamp_bits(rows, state);
+    current->pyramid.add(chunk_x, chunk_y, int64_t(chunk->get_population()) - int64_t(before));
+    invalidate_region({chunk_x, chunk_y});
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+size_t CellularAutomaton<StateT, RuleT>::apply_queued_edits() {
+    if (edit_queue.empty()) return 0;
+    
+    edit_batch.clear();
+    const size_t commands = edit_queue.drain([this](int32_t x, int32_t y, StateT state) {
+        std::tie(x, y) = fundamental_image(symmetry, x, y);
+        auto [lx, ly] = get_local_coord(x, y);
+        edit_batch.push_back({get_chunk_coord(x, y), uint32_t(edit_batch.size()),
+                              uint16_t(lx), uint16_t(ly), state});
+    });
+    std::sort(edit_batch.begin(), edit_batch.end(), [](const QueuedEdit& a, const QueuedEdit& b) {
+        return std::tie(a.chunk, a.order) < std::tie(b.chunk, b.order);
+    });
+    
+    // One chunk lookup, pyramid update and history reset per chunk
+    make_current_writable();
+    for (auto group = edit_batch.begin(); group != edit_batch.end();) {
+        const ChunkCoord coord = group->chunk;
+        auto end = std::find_if(group, edit_batch.end(), [&](const QueuedEdit& e) { return e.chunk != coord; });
+        
+        Chunk<StateT>* chunk = nullptr;
+        if (std::any_of(group, end, [this](const QueuedEdit& e) { return e.state != default_state; })) {
+            chunk = get_or_create_chunk(coord);
+        } else if (auto it = current->chunks.find(coord); it != current->chunks.end()) {
+            chunk = it->second.get();
+        }
+        
+        if (chunk) {
+            size_t before = chunk->get_population();
+            for (auto e = group; e != end; ++e) {
+                chunk->set_cell(e->x, e->y, e->state);
+            }
+            current->pyramid.add(coord.first, coord.second, int64_t(chunk->get_population()) - int64_t(before));
+            invalidate_region(coord);
+        }
+        group = end;
+    }
+    return commands;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+size_t CellularAutomaton<StateT, RuleT>::load_tile(const Candidate& candidate, StateT* out, int pad) {
+    constexpr int size = static_cast<int>(CHUNK_SIZE);
+    const int stride = size + 2 * pad;
+    std::fill(out, out + size_t(stride) * stride, default_state);
+    
+    size_t live_cells = 0;
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            const Chunk<StateT>* chunk = candidate.block[(dy + 1) * 3 + dx + 1];
+            if (!chunk) continue;
+            
+            // Part of the neighbor that falls inside the tile, in its local coordinates
+            int x0 = std::max(0, -dx * size - pad);
+            int x1 = std::min(size, stride - dx * size - pad);
+            int y0 = std::max(0, -dy * size - pad);
+            int y1 = std::min(size, stride - dy * size - pad);
+            if (x0 >= x1 || y0 >= y1) continue;
+            
+            StateT* region = out + size_t(dy * size + y0 + pad) * stride + (dx * size + x0 + pad);
+            const SymmetryTransform view = candidate.view[(dy + 1) * 3 + dx + 1];
+            if (view.identity()) {
+                live_cells += chunk->copy_region(x0, y0, x1 - x0, y1 - y0, region, stride);
+                continue;
+            }
+            // Mirrored or rotated neighbor: only a halo strip, read cell by cell
+            for (int y = y0; y < y1; ++y) {
+                for (int x = x0; x < x1; ++x) {
+                    auto [sx, sy] = view.apply(x, y, size - 1);
+                    const StateT state = chunk->get_cell(sx, sy);
+                    region[size_t(y - y0) * stride + (x - x0)] = state;
+                    live_cells += state != default_state;
+                }
+            }
+        }
+    }
+    return live_cells;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+size_t CellularAutomaton<StateT, RuleT>::advance_tile(const StateT* in, int size, StateT* out) {
+    if (!totalistic) {
+        return advance_gathered(in, size, out);
+    }
+    
+    const int stride = size + 2 * halo;
+    const size_t tile_cells = size_t(stride) * stride;
+    size_t population = 0;
+    next_churn = 0;
+    
+    for (size_t i = 0; i < tile_cells; ++i) {
+        live_mask[i] = in[i] != default_state;
+    }
+    
+    const bool counted = totalistic && NeighborCounter::supports(neighborhood);
+    if (counted) {
+        counter.count(live_mask.data(), size, halo, neighborhood, neighbor_counts.data());
+        
+        // Hot path, kept free of per-cell branching on the rule kind
+        size_t churn = 0;
+        for (int ly = 0; ly < size; ++ly) {
+            const StateT* row = in + size_t(ly + halo) * stride + halo;
+            const int32_t* counts = neighbor_counts.data() + size_t(ly) * size;
+            StateT* out_row = out + size_t(ly) * size;
+            for (int lx = 0; lx < size; ++lx) {
+                const StateT next = apply_count(row[lx], counts[lx]);
+                out_row[lx] = next;
+                population += next != StateT{};
+                churn += next != row[lx];
+            }
+        }
+        next_churn = churn;
+        return population;
+    }
+    
+    for (int ly = 0; ly < size; ++ly) {
+        for (int lx = 0; lx < size; ++lx) {
+            const size_t center = size_t(ly + halo) * stride + lx + halo;
+            const StateT current = in[center];
+            int live = 0;
+            for (const auto& [dx, dy] : neighbor_offsets) {
+                live += live_mask[center + ptrdiff_t(dy) * stride + dx];
+            }
+            const StateT next = apply_count(current, live);
+            
+            out[ly * size + lx] = next;
+            population += next != StateT{};
+            next_churn += next != current;
+        }
+    }
+    return population;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+size_t CellularAutomaton<StateT, RuleT>::advance_gathered(const StateT* in, int size, StateT* out) {
+    const int stride = size + 2 * halo;
+    const ptrdiff_t* offsets = gather_offsets_for(stride);
+    const size_t count = neighbor_offsets.size();
+    const StateT dead = default_state;
+    
+    // Everything the loop reads is in locals: stores through a StateT of
+    // character type could otherwise alias the members
+    return dispatch_gathered([=, this](auto n) {
+        constexpr size_t N = decltype(n)::value;
+        // A local copy of a fixed-size neighborhood stays in registers
+        std::array<ptrdiff_t, N> fixed;
+        std::copy_n(offsets, N, fixed.begin());
+        const ptrdiff_t* cell_offsets = N ? fixed.data() : offsets;
+        size_t population = 0;
+        size_t churn = 0;
+        for (int ly = 0; ly < size; ++ly) {
+            const StateT* row = in + size_t(ly + halo) * stride + halo;
+            StateT* out_row = out + size_t(ly) * size;
+            for (int lx = 0; lx < size; ++lx) {
+                const StateT* cell = row + lx;
+                const StateT next = apply_gathered<N>(cell, cell_offsets, count, dead);
+                out_row[lx] = next;
+                population += next != StateT{};
+                churn += next != *cell;
+            }
+        }
+        next_churn = churn;
+        return population;
+    });
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+size_t CellularAutomaton<StateT, RuleT>::compute_tile() {
+    return advance_tile(tile.get(), static_cast<int>(CHUNK_SIZE), next_cells.get());
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+size_t CellularAutomaton<StateT, RuleT>::compute_blocked_tile(int generations) {
+    constexpr int size = static_cast<int>(CHUNK_SIZE);
+    StateT* from = block_a.get();
+    StateT* to = block_b.get();
+    size_t population = 0;
+    
+    for (int g = generations - 1; g >= 0; --g) {
+        // After this generation the valid region still has g halos around the chunk
+        const int interior = size + 2 * g * halo;
+        StateT* out = g == 0 ? next_cells.get() : to;
+        population = advance_tile(from, interior, out);
+        std::swap(from, to);
+    }
+    return population;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+size_t CellularAutomaton<StateT, RuleT>::compute_sparse_tile() {
+    constexpr int size = static_cast<int>(CHUNK_SIZE);
+    touched.fill(0);
+    
+    // A live cell at l reaches every interior cell c with l - c in the
+    // neighborhood (or c == l); each neighborhood row is one contiguous span
+    for (int ty = 0; ty < tile_size; ++ty) {
+        const StateT* row = tile.get() + size_t(ty) * tile_size;
+        for (int tx = 0; tx < tile_size; ++tx) {
+            if (row[tx] == default_state) continue;
+            
+            const int x = tx - halo;
+            const int y = ty - halo;
+            for (int dy = -halo; dy <= halo; ++dy) {
+                const int cy = y - dy;
+                if (cy < 0 || cy >= size) continue;
+                const auto [lo, hi] = row_spans[dy + halo];
+                const int first = std::max(0, x - hi);
+                const int last = std::min(size - 1, x - lo);
+                if (first > last) continue;
+                const int width = last - first + 1;
+                touched[cy] |= (width == 64 ? ~uint64_t{0} : ((uint64_t{1} << width) - 1)) << first;
+            }
+        }
+    }
+    
+    next_keys.clear();
+    next_values.clear();
+    next_churn = 0;
+    
+    const ptrdiff_t* offsets = gather_offsets_for(tile_size);
+    const size_t count = neighbor_offsets.size();
+    const StateT dead = default_state;
+    auto evaluate = [&](auto n) {
+        constexpr size_t N = decltype(n)::value;
+        for (int ly = 0; ly < size; ++ly) {
+            uint64_t bits = touched[ly];
+            while (bits) {
+                const int lx = std::countr_zero(bits);
+                bits &= bits - 1;
+                
+                const StateT* cell = tile.get() + size_t(ly + halo) * tile_size + lx + halo;
+                StateT next;
+                if (totalistic) {
+                    int live = 0;
+                    for (size_t i = 0; i < count; ++i) {
+                        live += cell[offsets[i]] != dead;
+                    }
+                    next = apply_count(*cell, live);
+                } else {
+                    next = apply_gathered<N>(cell, offsets, count, dead);
+                }
+                
+                if (next != StateT{}) {
+                    next_keys.push_back(static_cast<uint16_t>(ly * size + lx));
+                    next_values.push_back(next);
+                }
+                next_churn += next != *cell;
+            }
+        }
+    };
+    if (totalistic) {
+        evaluate(std::integral_constant<size_t, 0>{});
+    } else {
+        dispatch_gathered(evaluate);
+    }
+    return next_keys.size();
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+size_t CellularAutomaton<StateT, RuleT>::compute_scatter(const Candidate& candidate, size_t& live_cells) {
+    constexpr int size = static_cast<int>(CHUNK_SIZE);
+    scatter_touched.clear();
+    live_cells = 0;
+    
+    auto touch = [this](int key) {
+        if (!scatter_mark[key]) {
+            scatter_mark[key] = 1;
+            scatter_touched.push_back(static_cast<uint16_t>(key));
+        }
+    };
+    
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            const Chunk<StateT>* chunk = candidate.block[(dy + 1) * 3 + dx + 1];
+            if (!chunk) continue;
+            
+            // Only the part of the neighbor within one halo of this chunk can reach it
+            const int x0 = std::max(0, -dx * size - halo);
+            const int x1 = std::min(size, size + halo - dx * size);
+            const int y0 = std::max(0, -dy * size - halo);
+            const int y1 = std::min(size, size + halo - dy * size);
+            if (x0 >= x1 || y0 >= y1) continue;
+            
+            const bool center = dx == 0 && dy == 0;
+            auto scatter = [&](int lx, int ly, StateT state) {
+                ++live_cells;
+                const int x = dx * size + lx;
+                const int y = dy * size + ly;
+                if (center) {
+                    scatter_center[y * size + x] = state;
+                    touch(y * size + x);
+                }
+                // Neighborhoods are symmetric, so the cells that see (x, y) are (x, y) + offset
+                for (const auto& [ox, oy] : neighbor_offsets) {
+                    const int cx = x + ox;
+                    const int cy = y + oy;
+                    if (unsigned(cx) >= unsigned(size) || unsigned(cy) >= unsigned(size)) continue;
+                    ++scatter_counts[cy * size + cx];
+                    touch(cy * size + cx);
+                }
+            };
+            
+            const SymmetryTransform view = candidate.view[(dy + 1) * 3 + dx + 1];
+            if (view.identity()) {
+                chunk->for_each_live_in(x0, y0, x1 - x0, y1 - y0, scatter);
+                continue;
+            }
+            // Visit the stored chunk's image of the strip and map its cells back
+            auto [ax, ay] = view.apply(x0, y0, size - 1);
+            auto [bx, by] = view.apply(x1 - 1, y1 - 1, size - 1);
+            const SymmetryTransform back = view.inverse();
+            chunk->for_each_live_in(std::min(ax, bx), std::min(ay, by), std::abs(bx - ax) + 1, std::abs(by - ay) + 1,
+                                    [&](int sx, int sy, StateT state) {
+                auto [lx, ly] = back.apply(sx, sy, size - 1);
+                scatter(lx, ly, state);
+            });
+        }
+    }
+    
+    // Ascending keys are what sparse chunk storage wants
+    std::sort(scatter_touched.begin(), scatter_touched.end());
+    next_keys.clear();
+    next_values.clear();
+    next_churn = 0;
+    
+    for (uint16_t key : scatter_touched) {
+        const StateT current = scatter_center[key];
+        const StateT next = apply_count(current, scatter_counts[key]);
+        if (next != StateT{}) {
+            next_keys.push_back(key);
+            next_values.push_back(next);
+        }
+        next_churn += next != current;
+        
+        scatter_counts[key] = 0;
+        scatter_center[key] = default_state;
+        scatter_mark[key] = 0;
+    }
+    return next_keys.size();
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::record_hash(RegionState& region, int64_t gen, uint64_t hash) {
+    constexpr int history = RegionState::HISTORY;
+    // Generations since the last record were not stepped, so the chunk was empty
+    for (int64_t g = std::max({region.last_gen + 1, gen - history + 1, int64_t{0}}); g < gen; ++g) {
+        region.hashes[g % history] = 0;
+    }
+    region.hashes[gen % history] = hash;
+    region.last_gen = gen;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+bool CellularAutomaton<StateT, RuleT>::hash_at(const RegionState& region, int64_t g, uint64_t& hash) const {
+    constexpr int history = RegionState::HISTORY;
+    if (g < history_start || g < region.valid_from || g < 0) return false;
+    if (g > region.last_gen) {
+        hash = 0;
+        return true;
+    }
+    if (g <= region.last_gen - history) return false;
+    hash = region.hashes[g % history];
+    return true;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+bool CellularAutomaton<StateT, RuleT>::hash_matches(ChunkCoord coord, int64_t gen_a, int64_t gen_b) const {
+    if (gen_a < history_start || gen_b < history_start) return false;
+    
+    auto it = regions.find(coord);
+    if (it == regions.end()) return true;   // Empty for at least a full history window
+    
+    uint64_t a, b;
+    return hash_at(it->second, gen_a, a) && hash_at(it->second, gen_b, b) && a == b;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+bool CellularAutomaton<StateT, RuleT>::neighborhood_repeats(ChunkCoord coord, int period, int64_t gen, int span) const {
+    for (int k = 0; k < span; ++k) {
+        // Center first: it rejects most chunks immediately
+        if (!hash_matches(coord, gen - k, gen - k - period)) return false;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                // A neighbor across a symmetry axis repeats when its stored image does
+                if ((dx || dy) && !hash_matches(fundamental_image(symmetry, coord.first + dx, coord.second + dy),
+                                                gen - k, gen - k - period)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::invalidate_region(ChunkCoord coord) {
+    if (!adaptive) return;
+    
+    RegionState& region = regions[coord];
+    region.valid_from = current->number + 1;
+    region.period = 0;
+    region.recorded = 0;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::reset_history() {
+    regions.clear();
+    history_start = current->number + 1;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::set_adaptive(bool enabled) {
+    adaptive = enabled;
+    reset_history();
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::set_symmetry(Symmetry group) {
+    if (!current->pyramid.empty() || !edit_queue.empty()) {
+        throw std::logic_error("set_symmetry: the universe already has cells");
+    }
+    if (group != Symmetry::None && !totalistic) {
+        throw std::invalid_argument("set_symmetry: the rule must be totalistic");
+    }
+    for (const SymmetryTransform& g : symmetry_group(group)) {
+        // Offsets move like differences of cells: flips negate them
+        for (const auto& [dx, dy] : neighbor_offsets) {
+            auto [gx, gy] = g.apply(dx, dy, 0);
+            if (!neighborhood.contains(gx, gy)) {
+                throw std::invalid_argument(std::string("set_symmetry: the neighborhood is not ")
+                                            + symmetry_name(group) + " symmetric");
+            }
+        }
+    }
+    symmetry = group;
+    reset_history();
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::set_temporal_blocking(int generations) {
+    constexpr int size = static_cast<int>(CHUNK_SIZE);
+    const int max_depth = std::max(1, size / halo);
+    
+    if (generations <= 0) {
+        // Deepest block whose scratch tiles stay in a typical 256 KiB L2 (two
+        // state buffers, the live mask, counts and the counter's prefix tables)
+        // and whose recomputed halo cells add at most a quarter to the work
+        constexpr size_t L2_BYTES = 256 * 1024;
+        constexpr double MAX_OVERHEAD = 0.25;
+        const size_t per_cell = 2 * sizeof(StateT) + sizeof(uint8_t) + 3 * sizeof(int32_t);
+        generations = 1;
+        double work = 0.0;
+        for (int depth = 1; depth <= max_depth; ++depth) {
+            const double side = size + 2.0 * depth * halo;
+            work += side * side / (size * size);
+            if (side * side * per_cell > L2_BYTES || work / depth > 1.0 + MAX_OVERHEAD) break;
+            generations = depth;
+        }
+    }
+    temporal_block = std::min(generations, max_depth);
+    
+    const size_t side = size + 2 * size_t(temporal_block) * halo;
+    if (temporal_block > 1) {
+        block_a = std::make_unique<StateT[]>(side * side);
+        block_b = std::make_unique<StateT[]>(side * side);
+    } else {
+        block_a.reset();
+        block_b.reset();
+    }
+    live_mask.resize(std::max(live_mask.size(), side * side));
+    neighbor_counts.resize(std::max(neighbor_counts.size(), side * side));
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+Generation<StateT>* CellularAutomaton<StateT, RuleT>::begin_step() {
+    const ChunkMap& chunks = current->chunks;
+    
+    // Build the next generation in a spare buffer so pinned readers are undisturbed.
+    // Its chunks, map nodes included, are parked by coordinate: a position
+    // usually gets back the buffer it had two generations ago, already sized
+    // and in the right storage mode
+    Generation<StateT>* next = acquire_spare_world();
+    while (!next->chunks.empty()) {
+        auto result = recycled.insert(next->chunks.extract(next->chunks.begin()));
+        if (!result.inserted) spare_nodes.push_back(std::move(result.node));
+    }
+    next->pyramid = current->pyramid;
+    
+    // Any chunk next to a live chunk may change (halo <= CHUNK_SIZE). Every
+    // chunk lists itself in the blocks of its 9 neighbors; grouping those by
+    // position gives each candidate its block without any map lookups. Under a
+    // symmetry each image of a chunk does the same for the stored neighbors
+    // around it
+    candidate_refs.clear();
+    for (const auto& [coord, chunk] : chunks) {
+        for (const SymmetryTransform& g : symmetry_group(symmetry)) {
+            auto [image_x, image_y] = g.apply(coord.first, coord.second, -1);
+            const SymmetryTransform view = g.inverse();
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if (!in_fundamental_domain(symmetry, image_x + dx, image_y + dy)) continue;
+                    candidate_refs.push_back({{image_x + dx, image_y + dy}, (1 - dy) * 3 + (1 - dx), chunk.get(), view});
+                }
+            }
+        }
+    }
+    std::sort(candidate_refs.begin(), candidate_refs.end(),
+              [](const CandidateRef& a, const CandidateRef& b) { return a.coord < b.coord; });
+    
+    candidates.clear();
+    for (const CandidateRef& ref : candidate_refs) {
+        if (candidates.empty() || candidates.back().coord != ref.coord) {
+            candidates.push_back({ref.coord, {}, {}});
+        }
+        candidates.back().block[ref.slot] = ref.chunk;
+        candidates.back().view[ref.slot] = ref.view;
+    }
+    return next;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+Chunk<StateT>* CellularAutomaton<StateT, RuleT>::emplace_chunk(ChunkMap& chunks, ChunkCoord coord) {
+    typename ChunkMap::node_type node = recycled.extract(coord);
+    if (!node && !spare_nodes.empty()) {
+        node = std::move(spare_nodes.back());
+        spare_nodes.pop_back();
+    }
+    if (!node && !recycled.empty()) {
+        node = recycled.extract(recycled.begin());
+    }
+    if (!node) {
+        return chunks.emplace(coord, std::make_unique<Chunk<StateT>>()).first->second.get();
+    }
+    
+    node.key() = coord;
+    return chunks.insert(std::move(node)).position->second.get();
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::freeze_chunk(Chunk<StateT>& chunk) {
+    freeze_keys.clear();
+    freeze_values.clear();
+    chunk.collect(freeze_keys, freeze_values);
+    
+    const uint64_t hash = chunk.content_hash();
+    auto& slot = frozen_blocks[hash];
+    typename Chunk<StateT>::Frozen block = slot.lock();
+    if (!block || !block->matches(freeze_keys, freeze_values)) {
+        block = std::make_shared<const FrozenCells<StateT>>(freeze_keys, freeze_values, hash);
+        slot = block;
+    }
+    chunk.freeze(std::move(block));
+    
+    if (frozen_blocks.size() >= frozen_sweep_at) {
+        std::erase_if(frozen_blocks, [](const auto& entry) { return entry.second.expired(); });
+        frozen_sweep_at = std::max<size_t>(64, 2 * frozen_blocks.size());
+    }
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::finish_step(Generation<StateT>* next, int generations) {
+    // Whatever was not reused belonged to chunks that died out
+    recycled.clear();
+    spare_nodes.clear();
+    shrink_index(next->chunks, next->chunks.size());
+    shrink_index(recycled, next->chunks.size());
+    next->number = current->number + generations;
+    current = next;
+    publish();
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::step_blocked(int generations) {
+    apply_queued_edits();
+    Generation<StateT>* next = begin_step();
+    const int pad = generations * halo;
+    last_stats = StrategyStats{};
+    
+    for (const Candidate& candidate : candidates) {
+        const ChunkCoord& coord = candidate.coord;
+        const Chunk<StateT>* previous = candidate.block[4];
+        int64_t previous_population = previous ? previous->get_population() : 0;
+        bool was_dense = previous && previous->dense();
+        
+        size_t population = load_tile(candidate, block_a.get(), pad) == 0 ? 0 : compute_blocked_tile(generations);
+        next->pyramid.add(coord.first, coord.second, int64_t(population) - previous_population);
+        ++last_stats.dense_chunks;
+        if (population == 0) continue;
+        
+        Chunk<StateT>* chunk = emplace_chunk(next->chunks, coord);
+        chunk->assign_cells(next_cells.get(), population, was_dense);
+        chunk->set_steady_steps(0);
+    }
+    
+    finish_step(next, generations);
+    // The skipped generations left no hashes behind
+    reset_history();
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::step() {
+    apply_queued_edits();
+    Generation<StateT>* next = begin_step();
+    
+    const int64_t gen = current->number;
+    const int64_t next_gen = gen + 1;
+    const size_t work_per_live = (neighbor_offsets.size() + 1) * (neighbor_offsets.size() + 1);
+    last_stats = StrategyStats{};
+    
+    for (const Candidate& candidate : candidates) {
+        const ChunkCoord& coord = candidate.coord;
+        const Chunk<StateT>* previous = candidate.block[4];
+        int64_t previous_population = previous ? previous->get_population() : 0;
+        bool was_dense = previous && previous->dense();
+        
+        RegionState* region = adaptive ? &regions[coord] : nullptr;
+        const bool stepped_last = region && region->last_gen == gen;
+        if (region && !stepped_last) {
+            // A gap breaks the recorded cycle
+            region->period = 0;
+            region->recorded = 0;
+        }
+        
+        // Replay when the whole 3x3 block is back where it was one period ago
+        StepStrategy strategy = StepStrategy::DenseTile;
+        size_t live_cells = 0;
+        if (region && region->period > 0 && region->verified) {
+            if (neighborhood_repeats(coord, region->period, gen, 1)) {
+                strategy = StepStrategy::Memoized;
+            } else {
+                region->period = 0;
+                region->recorded = 0;
+            }
+        }
+        
+        size_t population = 0;
+        size_t churn = 0;
+        uint64_t hash = 0;
+        Chunk<StateT>* chunk = nullptr;
+        
+        if (strategy == StepStrategy::Memoized) {
+            const size_t phase = size_t(next_gen % region->period);
+            Chunk<StateT>& replay = region->cycle[phase];
+            population = replay.get_population();
+            hash = region->cycle_hashes[phase];
+            churn = region->churn;
+            if (population > 0) {
+                // A cycle of period 1 is a still chunk; replay it from a shared block
+                if (region->period == 1 && !replay.is_frozen()) {
+                    freeze_chunk(replay);
+                }
+                chunk = emplace_chunk(next->chunks, coord);
+                *chunk = replay;
+                // Periods 1 and 2 count as settled, as on the computed path
+                const bool settled = region->period <= 2 && previous;
+                chunk->set_steady_steps(settled ? uint8_t(std::min(previous->steady_steps() + 1, int(UINT8_MAX))) : 0);
+            }
+        } else {
+            // Hysteresis: a sparse chunk stays sparse up to twice the budget
+            const size_t budget = SPARSE_WORK_BUDGET * (region && region->strategy == StepStrategy::SparseList ? 2 : 1);
+            bool computed = false;
+            
+            if (region && scatter_kernel) {
+                // A block of sparse chunks within budget skips the tile entirely
+                size_t block_population = 0;
+                bool all_sparse = true;
+                for (const Chunk<StateT>* neighbor : candidate.block) {
+                    if (!neighbor) continue;
+                    block_population += neighbor->get_population();
+                    all_sparse &= !neighbor->dense();
+                }
+                if (all_sparse && block_population * work_per_live < budget) {
+                    strategy = StepStrategy::SparseList;
+                    population = compute_scatter(candidate, live_cells);
+                    computed = true;
+                }
+            }
+            
+            if (!computed) {
+                live_cells = load_tile(candidate, tile.get(), halo);
+                if (region) {
+                    strategy = live_cells * work_per_live < budget ? StepStrategy::SparseList : StepStrategy::DenseTile;
+                }
+                if (live_cells > 0) {
+                    population = strategy == StepStrategy::SparseList ? compute_sparse_tile() : compute_tile();
+                    computed = true;
+                }
+            }
+            
+            if (computed) {
+                churn = next_churn;
+            }
+            if (population > 0) {
+                // This position two generations ago, if its chunk is still parked
+                auto parked = recycled.find(coord);
+                const Chunk<StateT>* before = parked != recycled.end() ? parked->second.get() : nullptr;
+                
+                // Both need the chunk of the generation in between: one that died
+                // out and came back with its old content has not settled
+                const bool unchanged = churn == 0 && previous;
+                const bool repeated = !unchanged && previous && before && before->is_frozen() &&
+                    (strategy == StepStrategy::SparseList
+                         ? before->frozen_block()->matches(next_keys, next_values)
+                         : before->frozen_block()->matches(next_cells.get(), population));
+                
+                // emplace_chunk hands back the parked chunk, so a repeat is already in place
+                chunk = emplace_chunk(next->chunks, coord);
+                if (unchanged && previous->is_frozen()) {
+                    *chunk = *previous;
+                } else if (!repeated && strategy == StepStrategy::SparseList) {
+                    chunk->assign_sparse(next_keys, next_values, was_dense);
+                } else if (!repeated) {
+                    chunk->assign_cells(next_cells.get(), population, was_dense);
+                }
+                
+                // Period 1 or 2; without frozen blocks yet, a period 2 shows in the hash
+                // history. Every way of settling implies a previous chunk
+                bool settled = unchanged || repeated;
+                if (region) {
+                    hash = chunk->content_hash();
+                    uint64_t two_back;
+                    if (!settled && previous && hash_at(*region, gen - 1, two_back)) {
+                        settled = hash == two_back;
+                    }
+                }
+                chunk->set_steady_steps(settled ? uint8_t(std::min(previous->steady_steps() + 1, int(UINT8_MAX))) : 0);
+                if (!chunk->is_frozen() && chunk->steady_steps() >= SETTLE_STEPS) {
+                    freeze_chunk(*chunk);
+                }
+            }
+        }
+        
+        // Long settled, unlikely to thaw again
+        if (chunk && chunk->is_frozen() && chunk->steady_steps() >= SCRATCH_STEADY_STEPS) {
+            chunk->trim();
+        }
+        
+        next->pyramid.add(coord.first, coord.second, int64_t(population) - previous_population);
+        
+        if (region) {
+            if (strategy != StepStrategy::Memoized) {
+                // The computed path above already hashed a new chunk
+                if (!chunk) hash = 0;
+                if (region->period > 0 && region->recorded < region->period) {
+                    const size_t phase = size_t(next_gen % region->period);
+                    region->cycle[phase] = chunk ? *chunk : Chunk<StateT>();
+                    region->cycle_hashes[phase] = hash;
+                    ++region->recorded;
+                } else if (region->period > 0 && !region->verified) {
+                    // The cycle was found by hash; replay only once a computed
+                    // generation matches the one recorded a period earlier
+                    const Chunk<StateT>& expected = region->cycle[size_t(next_gen % region->period)];
+                    region->verified = chunk ? chunk->same_cells(expected) : expected.get_population() == 0;
+                    if (!region->verified) {
+                        region->period = 0;
+                        region->recorded = 0;
+                    }
+                }
+            }
+            record_hash(*region, next_gen, hash);
+            
+            if (stepped_last && region->strategy != strategy) {
+                ++last_stats.switches;
+                if (strategy_logger) {
+                    strategy_logger({next_gen, coord.first, coord.second, region->strategy, strategy,
+                                     live_cells, region->churn, region->period});
+                }
+            }
+            region->strategy = strategy;
+            region->churn = churn;
+        }
+        
+        switch (strategy) {
+            case StepStrategy::SparseList: ++last_stats.sparse_chunks; break;
+            case StepStrategy::DenseTile: ++last_stats.dense_chunks; break;
+            case StepStrategy::Memoized: ++last_stats.memoized_chunks; break;
+        }
+        last_stats.churn += churn;
+    }
+    if (adaptive) {
+        // Look for periods now that every candidate has its newest hash
+        for (const Candidate& candidate : candidates) {
+            RegionState& region = regions[candidate.coord];
+            if (region.period > 0 || region.churn > CHAOTIC_CHURN) continue;
+            for (int period = 1; period <= MAX_PERIOD; ++period) {
+                if (neighborhood_repeats(candidate.coord, period, next_gen, period)) {
+                    region.period = period;
+                    region.recorded = 0;
+                    region.verified = false;
+                    region.cycle.assign(period, Chunk<StateT>());
+                    region.cycle_hashes.assign(period, 0);
+                    break;
+                }
+            }
+        }
+        
+        // Regions untouched for a whole history window are indistinguishable from absent ones
+        if (next_gen % RegionState::HISTORY == 0) {
+            std::erase_if(regions, [next_gen](const auto& entry) {
+                return entry.second.last_gen + RegionState::HISTORY < next_gen;
+            });
+        }
+    }
+    
+    finish_step(next, 1);
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+DensityRaster CellularAutomaton<StateT, RuleT>::density_of(const Generation<StateT>& world, Symmetry symmetry,
+                                                    const CellRect& rect, int level) {
+    constexpr int chunk_shift = std::countr_zero(CHUNK_SIZE);
+    if (level < 0 || level >= chunk_shift + DensityPyramid::LEVELS) {
+        throw std::out_of_range("query_density: level outside the density pyramid");
+    }
+    
+    DensityRaster raster;
+    if (rect.width <= 0 || rect.height <= 0) return raster;
+    
+    if (symmetry != Symmetry::None) {
+        // Each cell of rect is the image of exactly one stored cell, so add up
+        // the stored counts over every image of rect. Transforms map aligned
+        // pixels onto aligned pixels, with pixel indices moving like cells
+        raster = density_of(world, Symmetry::None, rect, level);
+        const int64_t cell = int64_t(1) << level;
+        const int64_t px0 = raster.x / cell;
+        const int64_t py0 = raster.y / cell;
+        for (const SymmetryTransform& g : symmetry_group(symmetry).subspan(1)) {
+            auto [ax, ay] = g.apply(rect.x, rect.y, -1);
+            auto [bx, by] = g.apply(rect.x + rect.width - 1, rect.y + rect.height - 1, -1);
+            const CellRect image{std::min(ax, bx), std::min(ay, by), std::abs(bx - ax) + 1, std::abs(by - ay) + 1};
+            const DensityRaster part = density_of(world, Symmetry::None, image, level);
+            
+            const SymmetryTransform back = g.inverse();
+            for (int j = 0; j < part.height; ++j) {
+                for (int i = 0; i < part.width; ++i) {
+                    const uint32_t count = part.counts[size_t(j) * part.width + i];
+                    if (count == 0) continue;
+                    auto [pi, pj] = back.apply(part.x / cell + i, part.y / cell + j, int64_t(-1));
+                    uint32_t& out = raster.counts[size_t(pj - py0) * raster.width + size_t(pi - px0)];
+                    out = static_cast<uint32_t>(std::min<uint64_t>(uint64_t(out) + count, UINT32_MAX));
+                }
+            }
+        }
+        return raster;
+    }
+    
+    // Pixel grid aligned to multiples of the pixel size (floor / ceil in pixel units)
+    const int64_t cell = int64_t(1) << level;
+    auto floor_div = [](int64_t v, int64_t d) { return v >= 0 ? v / d : -((-v + d - 1) / d); };
+    const int64_t px0 = floor_div(rect.x, cell);
+    const int64_t py0 = floor_div(rect.y, cell);
+    const int64_t px1 = floor_div(int64_t(rect.x) + rect.width - 1, cell) + 1;
+    const int64_t py1 = floor_div(int64_t(rect.y) + rect.height - 1, cell) + 1;
+    
+    raster.x = static_cast<int32_t>(px0 * cell);
+    raster.y = static_cast<int32_t>(py0 * cell);
+    raster.cell_size = static_cast<int32_t>(std::min<int64_t>(cell, INT32_MAX));
+    raster.width = static_cast<int>(px1 - px0);
+    raster.height = static_cast<int>(py1 - py0);
+    raster.counts.assign(size_t(raster.width) * raster.height, 0);
+    
+    if (level >= chunk_shift) {
+        // Each pixel is exactly one pyramid node
+        const int node_level = level - chunk_shift;
+        for (int j = 0; j < raster.height; ++j) {
+            for (int i = 0; i < raster.width; ++i) {
+                uint64_t count = world.pyramid.count(node_level, int32_t(px0 + i), int32_t(py0 + j));
+                raster.counts[size_t(j) * raster.width + i] = static_cast<uint32_t>(std::min<uint64_t>(count, UINT32_MAX));
+            }
+        }
+        return raster;
+    }
+    
+    // Sub-chunk pixels: bin the live cells of every non-empty chunk under the raster
+    const int32_t size = static_cast<int32_t>(CHUNK_SIZE);
+    const int32_t first_cx = get_chunk_coord(raster.x, raster.y).first;
+    const int32_t first_cy = get_chunk_coord(raster.x, raster.y).second;
+    const int32_t last_cx = get_chunk_coord(static_cast<int32_t>((px1 * cell) - 1), 0).first;
+    const int32_t last_cy = get_chunk_coord(0, static_cast<int32_t>((py1 * cell) - 1)).second;
+    
+    for (int32_t cy = first_cy; cy <= last_cy; ++cy) {
+        for (int32_t cx = first_cx; cx <= last_cx; ++cx) {
+            if (world.pyramid.count(0, cx, cy) == 0) continue;
+            auto it = world.chunks.find({cx, cy});
+            if (it == world.chunks.end()) continue;
+            
+            const int64_t base_x = int64_t(cx) * size;
+            const int64_t base_y = int64_t(cy) * size;
+            it->second->for_each_live([&](int lx, int ly, StateT) {
+                const int64_t i = ((base_x + lx) >> level) - px0;
+                const int64_t j = ((base_y + ly) >> level) - py0;
+                if (i >= 0 && i < raster.width && j >= 0 && j < raster.height) {
+                    ++raster.counts[size_t(j) * raster.width + i];
+                }
+            });
+        }
+    }
+    return raster;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+std::optional<BoundingBox> CellularAutomaton<StateT, RuleT>::bounds_of(const Generation<StateT>& world, Symmetry symmetry) {
+    std::vector<DensityPyramid::NodeCoord> left, right, top, bottom;
+    if (!world.pyramid.edge_chunks(left, right, top, bottom)) return std::nullopt;
+    
+    const int32_t size = static_cast<int32_t>(CHUNK_SIZE);
+    BoundingBox box{INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN};
+    
+    // Only the chunks on each edge can hold the extreme cells
+    auto scan = [&](const std::vector<DensityPyramid::NodeCoord>& edge) {
+        for (const auto& coord : edge) {
+            auto it = world.chunks.find(coord);
+            if (it == world.chunks.end()) continue;
+            it->second->for_each_live([&](int lx, int ly, StateT) {
+                const int32_t x = coord.first * size + lx;
+                const int32_t y = coord.second * size + ly;
+                box.min_x = std::min(box.min_x, x);
+                box.max_x = std::max(box.max_x, x);
+                box.min_y = std::min(box.min_y, y);
+                box.max_y = std::max(box.max_y, y);
+            });
+        }
+    };
+    scan(left);
+    scan(right);
+    scan(top);
+    scan(bottom);
+    
+    // The images of the stored box bound the images of the stored cells
+    const BoundingBox stored = box;
+    for (const SymmetryTransform& g : symmetry_group(symmetry).subspan(1)) {
+        auto [ax, ay] = g.apply(stored.min_x, stored.min_y, -1);
+        auto [bx, by] = g.apply(stored.max_x, stored.max_y, -1);
+        box.min_x = std::min({box.min_x, ax, bx});
+        box.max_x = std::max({box.max_x, ax, bx});
+        box.min_y = std::min({box.min_y, ay, by});
+        box.max_y = std::max({box.max_y, ay, by});
+    }
+    return box;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+DensityRaster CellularAutomaton<StateT, RuleT>::query_density(const CellRect& rect, int level) const {
+    return density_of(*current, symmetry, rect, level);
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+std::optional<BoundingBox> CellularAutomaton<StateT, RuleT>::bounding_box() const {
+    return bounds_of(*current, symmetry);
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+MemoryUsage CellularAutomaton<StateT, RuleT>::memory_usage() const {
+    MemoryUsage usage;
+    
+    // Chunk counts describe the current generation; bytes cover every
+    // generation still resident (the double buffer plus any pinned by readers)
+    for (const auto& [coord, chunk] : current->chunks) {
+        if (chunk->is_frozen()) {
+            ++usage.frozen_chunks;
+        } else {
+            ++(chunk->dense() ? usage.dense_chunks : usage.sparse_chunks);
+        }
+    }
+    
+    // Node-based map: one bucket pointer per bucket, one node per entry
+    struct Node { void* next; typename ChunkMap::value_type value; size_t hash; };
+    
+    // Frozen blocks are shared across generations and chunks; count each once
+    std::unordered_set<const FrozenCells<StateT>*> blocks;
+    for (const auto& world : worlds) {
+        for (const auto& [coord, chunk] : world->chunks) {
+            if (const FrozenCells<StateT>* block = chunk->frozen_block()) {
+                usage.frozen_bytes += chunk->memory_usage();
+                if (blocks.insert(block).second) usage.frozen_bytes += block->memory_usage();
+                continue;
+            }
+            (chunk->dense() ? usage.dense_bytes : usage.sparse_bytes) += chunk->memory_usage();
+        }
+        usage.index_bytes += sizeof(Generation<StateT>) + world->chunks.bucket_count() * sizeof(void*)
+                           + world->chunks.size() * sizeof(Node) + world->pyramid.memory_usage();
+    }
+    usage.index_bytes += recycled.bucket_count() * sizeof(void*);
+    
+    for (const auto& [coord, region] : regions) {
+        usage.cycle_bytes += (region.cycle.capacity() - region.cycle.size()) * sizeof(Chunk<StateT>)
+                           + region.cycle_hashes.capacity() * sizeof(uint64_t);
+        for (const Chunk<StateT>& chunk : region.cycle) {
+            usage.cycle_bytes += chunk.memory_usage();
+            const FrozenCells<StateT>* block = chunk.frozen_block();
+            if (block && blocks.insert(block).second) usage.cycle_bytes += block->memory_usage();
+        }
+    }
+    return usage;
+}
+
+template<typename StateT, CellRule<StateT> RuleT>
+void CellularAutomaton<StateT, RuleT>::run(int64_t iterations) {
+    while (iterations > 0) {
+        const int generations = static_cast<int>(std::min<int64_t>(temporal_block, iterations));
+        if (generations > 1) {
+            step_blocked(generations);
+        } else {
+            step();
+        }
+        iterations -= generations;
+    }
+}
+
+template<typename StateT, typename RuleT>
+void print_pattern(const CellularAutomaton<StateT, RuleT>& ca, int start_x, int start_y, int width, int height) {
+    for (int y = start_y; y < start_y + height; ++y) {
+        for (int x = start_x; x < start_x + width; ++x) {
+            std::cout << (ca.get_cell(x, y) ? '#' : '.');
+        }
+        std::cout << '\n';
+    }
+    std::cout << std::endl;
+}
+
+template<typename StateT>
+void print_pattern(const GenerationSnapshot<StateT>& snapshot, int start_x, int start_y, int width, int height) {
+    for (int y = start_y; y < start_y + height; ++y) {
+        for (int x = start_x; x < start_x + width; ++x) {
+            std::cout << (snapshot.get_cell(x, y) ? '#' : '.');
+        }
+        std::cout << '\n';
+    }
+    std::cout << std::endl;
+}
+
+#endif // CELLULAR_AUTOMATON_IMPL_HPP
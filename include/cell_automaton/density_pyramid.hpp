@@ -0,0 +1,111 @@
+#ifndef DENSITY_PYRAMID_HPP
+#define DENSITY_PYRAMID_HPP
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+/**
+ * Quadtree of live-cell counts over chunk coordinates.
+ *
+ * Level 0 holds one count per non-empty chunk; a node at level L covers
+ * 2^L x 2^L chunks. Counts are maintained incrementally with add(), so
+ * zoomed-out views and bounds never need to touch chunk storage.
+ * Nodes whose count drops to zero are removed.
+ *
+ * Levels are open-addressing tables, so once they have grown to the size of
+ * the world neither add() nor copying a pyramid allocates. A level that
+ * empties below 1/8 of its table shrinks, and copying from a pyramid that
+ * did lets go of the larger table as well.
+ */
+class DensityPyramid {
+public:
+    static constexpr int LEVELS = 20;
+    
+    using NodeCoord = std::pair<int32_t, int32_t>;
+    
+    // Apply a population change of the chunk at (chunk_x, chunk_y) to every level
+    void add(int32_t chunk_x, int32_t chunk_y, int64_t delta);
+    
+    // Live cells under the node (node_x, node_y) of level, 0 if absent
+    uint64_t count(int level, int32_t node_x, int32_t node_y) const;
+    
+    uint64_t total() const { return population; }
+    bool empty() const { return population == 0; }
+    void clear();
+    // Clear and free every level table
+    void release();
+    
+    /**
+     * Non-empty chunks on each side of the chunk bounding box, found by
+     * descending from the top level and keeping only the extreme nodes.
+     * Returns false when the pyramid is empty.
+     */
+    bool edge_chunks(std::vector<NodeCoord>& min_x, std::vector<NodeCoord>& max_x,
+                     std::vector<NodeCoord>& min_y, std::vector<NodeCoord>& max_y) const;
+    
+    size_t memory_usage() const;
+    
+private:
+    /**
+     * Linear-probing map from packed node coordinates to non-zero counts; a
+     * zero count marks an empty slot. Erasure shifts the following cluster
+     * back, so there are no tombstones.
+     */
+    class Level {
+    public:
+        struct Slot {
+            uint64_t key = 0;
+            uint64_t count = 0;
+        };
+        
+        Level() = default;
+        Level(const Level&) = default;
+        Level(Level&&) noexcept = default;
+        Level& operator=(Level&&) noexcept = default;
+        // Keeps the table of this level unless it is over twice the size of other's
+        Level& operator=(const Level& other);
+        
+        uint64_t get(uint64_t key) const;
+        // Add delta to the count of key, inserting or removing the node as needed
+        void add(uint64_t key, int64_t delta);
+        void clear();
+        size_t size() const { return used; }
+        size_t memory_usage() const { return slots.capacity() * sizeof(Slot); }
+        void release();
+        
+        template<typename Fn>
+        void for_each(Fn&& fn) const {
+            for (const Slot& slot : slots) {
+                if (slot.count != 0) fn(slot.key, slot.count);
+            }
+        }
+        
+    private:
+        std::vector<Slot> slots;    // Power-of-two size, 1/8 to 3/4 full above 16 slots
+        size_t used = 0;
+        
+        size_t home(uint64_t key) const {
+            return size_t((key * 0x9E3779B97F4A7C15ULL) >> 32) & (slots.size() - 1);
+        }
+        void rebuild(size_t size);
+        void erase_at(size_t index);
+    };
+    
+    std::array<Level, LEVELS> levels;
+    uint64_t population = 0;
+    
+    static uint64_t pack(int32_t x, int32_t y) {
+        return (uint64_t(uint32_t(x)) << 32) | uint32_t(y);
+    }
+    static NodeCoord unpack(uint64_t key) {
+        return {int32_t(uint32_t(key >> 32)), int32_t(uint32_t(key))};
+    }
+    
+    // axis 0 = x, 1 = y; want_max selects the far side
+    void descend_edge(int axis, bool want_max, std::vector<NodeCoord>& out) const;
+};
+
+#endif // DENSITY_PYRAMID_HPP
@@ -0,0 +1,99 @@
+#ifndef EDIT_QUEUE_HPP
+#define EDIT_QUEUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// One cell of an edit; pattern cells are relative to the stamp origin
+template<typename StateT>
+struct CellEdit {
+    int32_t x, y;
+    StateT state;
+};
+
+/**
+ * Multi-producer, single-consumer queue of cell edits.
+ *
+ * push() and push_pattern() may be called from any number of threads; they
+ * only allocate the command and CAS it onto an intrusive stack, so producers
+ * never block each other or the consumer. The consumer detaches the whole
+ * stack with one exchange and visits it oldest first, which keeps the edits
+ * of each producer in the order they were pushed.
+ */
+template<typename StateT>
+class EditQueue {
+public:
+    struct Command {
+        int32_t x, y;                          // The cell, or the origin of a pattern
+        StateT state;                          // Unused for patterns
+        std::vector<CellEdit<StateT>> pattern; // Empty for a single cell
+        Command* next = nullptr;
+    };
+
+    EditQueue() = default;
+    EditQueue(const EditQueue&) = delete;
+    EditQueue& operator=(const EditQueue&) = delete;
+    ~EditQueue() { release(head.exchange(nullptr, std::memory_order_acquire)); }
+
+    void push(int32_t x, int32_t y, StateT state) {
+        link(new Command{x, y, state, {}});
+    }
+
+    void push_pattern(int32_t x, int32_t y, std::vector<CellEdit<StateT>> cells) {
+        if (cells.empty()) return;
+        link(new Command{x, y, StateT{}, std::move(cells)});
+    }
+
+    // A hint only: producers may push right after this returns true
+    bool empty() const { return head.load(std::memory_order_relaxed) == nullptr; }
+
+    /**
+     * Consumer only. Call fn(x, y, state) for every cell pushed so far, oldest
+     * command first, and free the commands. Returns the number of commands.
+     */
+    template<typename Fn>
+    size_t drain(Fn&& fn) {
+        if (empty()) return 0;
+
+        // The stack is newest first; reverse it into push order
+        Command* oldest = nullptr;
+        for (Command* c = head.exchange(nullptr, std::memory_order_acquire); c;) {
+            Command* next = c->next;
+            c->next = oldest;
+            oldest = c;
+            c = next;
+        }
+
+        size_t commands = 0;
+        for (Command* c = oldest; c; c = c->next, ++commands) {
+            if (c->pattern.empty()) {
+                fn(c->x, c->y, c->state);
+            }
+            for (const CellEdit<StateT>& cell : c->pattern) {
+                fn(c->x + cell.x, c->y + cell.y, cell.state);
+            }
+        }
+        release(oldest);
+        return commands;
+    }
+
+private:
+    std::atomic<Command*> head{nullptr};
+
+    void link(Command* command) {
+        command->next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(command->next, command,
+                                           std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void release(Command* c) {
+        while (c) {
+            delete std::exchange(c, c->next);
+        }
+    }
+};
+
+#endif // EDIT_QUEUE_HPP
@@ -0,0 +1,38 @@
+#ifndef NEIGHBOR_COUNTER_HPP
+#define NEIGHBOR_COUNTER_HPP
+
+#include <vector>
+#include <cstdint>
+#include "rules/neighborhood.hpp"
+
+/**
+ * Live-neighbor counts for every interior cell of a tile.
+ *
+ * The tile is a (size + 2 * halo)^2 row-major 0/1 mask: one chunk, or a
+ * temporally blocked region of size x size cells, plus a halo of its neighbors. Moore neighborhoods are counted with a summed-area
+ * table and von Neumann neighborhoods with a sliding diamond over diagonal
+ * prefix sums, so the cost per cell does not depend on the radius.
+ * Buffers are kept between calls.
+ */
+class NeighborCounter {
+private:
+    std::vector<int32_t> table_a;
+    std::vector<int32_t> table_b;
+    
+    void count_moore(const uint8_t* live, int size, int halo, int radius, int32_t* out);
+    void count_von_neumann(const uint8_t* live, int size, int halo, int radius, int32_t* out);
+    
+public:
+    static bool supports(const cell_automaton::rules::Neighborhood& nb);
+    
+    /**
+     * @param live Tile mask, 1 for cells not in the default state
+     * @param size Side of the tile interior, CHUNK_SIZE for a single chunk
+     * @param halo Halo width of the tile; must be at least nb.radius
+     * @param nb Neighborhood to count (Moore or von Neumann)
+     * @param out size * size counts, center cell excluded
+     */
+    void count(const uint8_t* live, int size, int halo, const cell_automaton::rules::Neighborhood& nb, int32_t* out);
+};
+
+#endif // NEIGHBOR_COUNTER_HPP
@@ -0,0 +1,48 @@
+#ifndef STEP_STRATEGY_HPP
+#define STEP_STRATEGY_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+/**
+ * How a chunk is advanced by one generation. All strategies produce identical
+ * results; the automaton picks one per chunk from what it measured before.
+ */
+enum class StepStrategy : uint8_t {
+    SparseList,    // Evaluate only cells within reach of a live cell
+    DenseTile,     // Evaluate every cell of the chunk from its halo tile
+    Memoized       // Replay a recorded cycle while the neighborhood repeats
+};
+
+inline const char* strategy_name(StepStrategy strategy) {
+    switch (strategy) {
+        case StepStrategy::SparseList: return "sparse";
+        case StepStrategy::DenseTile: return "dense";
+        case StepStrategy::Memoized: return "memoized";
+    }
+    return "unknown";
+}
+
+// One chunk switching strategy, reported to the strategy logger
+struct StrategyChange {
+    int64_t generation;          // Generation being computed
+    int32_t chunk_x, chunk_y;
+    StepStrategy from, to;
+    size_t live_cells;           // Non-default cells in the chunk and its halo
+    size_t churn;                // Cells that changed in the previous step of this chunk
+    int period;                  // Detected period, 0 if none
+};
+
+// Per-step totals, see CellularAutomaton::get_strategy_stats()
+struct StrategyStats {
+    size_t sparse_chunks = 0;
+    size_t dense_chunks = 0;
+    size_t memoized_chunks = 0;
+    size_t switches = 0;
+    size_t churn = 0;            // Cells that changed in the last step
+};
+
+using StrategyLogger = std::function<void(const StrategyChange&)>;
+
+#endif // STEP_STRATEGY_HPP
@@ -0,0 +1,103 @@
+#ifndef SYMMETRY_HPP
+#define SYMMETRY_HPP
+
+#include <cstdint>
+#include <span>
+#include <utility>
+
+/**
+ * Symmetry group declared for a universe, see CellularAutomaton::set_symmetry().
+ *
+ * Every axis and center lies on the corner (-0.5, -0.5), between cells and
+ * on chunk boundaries, so no cell is its own image and every transform maps
+ * whole chunks onto whole chunks.
+ */
+enum class Symmetry : uint8_t {
+    None,   // C1
+    C2,     // 180-degree rotation; stores the half-plane y >= 0
+    C4,     // 90-degree rotations; stores the quadrant x >= 0, y >= 0
+    D2,     // Reflection in x = -0.5; stores x >= 0
+    D4      // Reflections in x = -0.5 and y = -0.5; stores x >= 0, y >= 0
+};
+
+inline const char* symmetry_name(Symmetry symmetry) {
+    switch (symmetry) {
+        case Symmetry::None: return "C1";
+        case Symmetry::C2: return "C2";
+        case Symmetry::C4: return "C4";
+        case Symmetry::D2: return "D2";
+        case Symmetry::D4: return "D4";
+    }
+    return "unknown";
+}
+
+// Optional x/y swap followed by optional flips v -> last - v
+struct SymmetryTransform {
+    bool swap = false;
+    bool flip_x = false;
+    bool flip_y = false;
+
+    bool identity() const { return !swap && !flip_x && !flip_y; }
+
+    /**
+     * @param last -1 for world and chunk coordinates, CHUNK_SIZE - 1 for
+     *             local coordinates within a chunk
+     */
+    template<typename T>
+    std::pair<T, T> apply(T x, T y, T last) const {
+        if (swap) std::swap(x, y);
+        return {flip_x ? last - x : x, flip_y ? last - y : y};
+    }
+
+    SymmetryTransform inverse() const {
+        return {swap, swap ? flip_y : flip_x, swap ? flip_x : flip_y};
+    }
+};
+
+// Elements of the group, identity first
+inline std::span<const SymmetryTransform> symmetry_group(Symmetry symmetry) {
+    static constexpr SymmetryTransform none[] = {{}};
+    static constexpr SymmetryTransform c2[] = {{}, {false, true, true}};
+    static constexpr SymmetryTransform c4[] = {{}, {true, true, false}, {false, true, true}, {true, false, true}};
+    static constexpr SymmetryTransform d2[] = {{}, {false, true, false}};
+    static constexpr SymmetryTransform d4[] = {{}, {false, true, false}, {false, false, true}, {false, true, true}};
+    switch (symmetry) {
+        case Symmetry::None: break;
+        case Symmetry::C2: return c2;
+        case Symmetry::C4: return c4;
+        case Symmetry::D2: return d2;
+        case Symmetry::D4: return d4;
+    }
+    return none;
+}
+
+// Whether a cell, or a chunk by chunk coordinates, is in the stored domain
+template<typename T>
+bool in_fundamental_domain(Symmetry symmetry, T x, T y) {
+    switch (symmetry) {
+        case Symmetry::None: return true;
+        case Symmetry::C2: return y >= 0;
+        case Symmetry::D2: return x >= 0;
+        case Symmetry::C4:
+        case Symmetry::D4: return x >= 0 && y >= 0;
+    }
+    return true;
+}
+
+// The group element that takes (x, y), cell or chunk coordinates, into the stored domain
+template<typename T>
+SymmetryTransform to_fundamental_domain(Symmetry symmetry, T x, T y) {
+    for (const SymmetryTransform& g : symmetry_group(symmetry)) {
+        auto [gx, gy] = g.apply(x, y, T(-1));
+        if (in_fundamental_domain(symmetry, gx, gy)) return g;
+    }
+    return {};
+}
+
+// The image of (x, y) in the stored domain
+template<typename T>
+std::pair<T, T> fundamental_image(Symmetry symmetry, T x, T y) {
+    return to_fundamental_domain(symmetry, x, y).apply(x, y, T(-1));
+}
+
+#endif // SYMMETRY_HPP
@@ -2,6 +2,7 @@
 #define PATTERN_LIBRARY_HPP
 
 #include "cell_automaton/cellular_automaton.hpp"
+#include <cstdint>
 
 namespace cell_automaton {
 namespace patterns {
@@ -10,7 +11,8 @@ namespace patterns {
 void create_glider(CellularAutomaton<bool>& ca, int x, int y);
 void create_r_pentomino(CellularAutomaton<bool>& ca, int x, int y);
 void create_gosper_glider_gun(CellularAutomaton<bool>& ca, int x, int y);
-void create_random_soup(CellularAutomaton<bool>& ca, int x, int y, int width, int height, double density = 0.3);
+void create_random_soup(CellularAutomaton<bool>& ca, int x, int y, int width, int height, double density = 0.3,
+                        uint64_t seed = 42, unsigned threads = 0);
 
 // Utility functions
 void print_pattern(const CellularAutomaton<bool>& ca, int min_x, int min_y, int max_x, int max_y);
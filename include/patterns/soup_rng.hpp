@@ -0,0 +1,74 @@
+#ifndef SOUP_RNG_HPP
+#define SOUP_RNG_HPP
+
+#include <cstdint>
+#include <bit>
+
+namespace cell_automaton {
+namespace patterns {
+
+/**
+ * xoshiro256** generator used for random soups.
+ *
+ * Each stream is seeded from (seed, stream_x, stream_y) through splitmix64, so
+ * every chunk gets its own independent sequence and the result of a soup does
+ * not depend on how chunks are distributed across threads.
+ */
+class SoupRng {
+private:
+    uint64_t s[4];
+
+    static uint64_t splitmix64(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+public:
+    explicit SoupRng(uint64_t seed) {
+        for (uint64_t& word : s) {
+            word = splitmix64(seed);
+        }
+    }
+
+    static SoupRng for_stream(uint64_t seed, int32_t stream_x, int32_t stream_y) {
+        uint64_t key = seed;
+        uint64_t mixed = splitmix64(key) ^ ((uint64_t(uint32_t(stream_x)) << 32) | uint32_t(stream_y));
+        return SoupRng(splitmix64(mixed));
+    }
+
+    uint64_t next() {
+        uint64_t result = std::rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = std::rotl(s[3], 45);
+        return result;
+    }
+
+    /**
+     * 64 independent bits, each set with probability threshold / 65536.
+     *
+     * Walks the binary expansion of the threshold from its lowest set bit,
+     * OR-ing a fresh word in for 1 bits and AND-ing for 0 bits.
+     */
+    uint64_t bernoulli_word(uint32_t threshold) {
+        if (threshold == 0) return 0;
+        if (threshold >= 65536) return ~uint64_t{0};
+
+        uint64_t word = 0;
+        for (int bit = std::countr_zero(threshold); bit < 16; ++bit) {
+            word = ((threshold >> bit) & 1) ? (word | next()) : (word & next());
+        }
+        return word;
+    }
+};
+
+} // namespace patterns
+} // namespace cell_automaton
+
+#endif // SOUP_RNG_HPP
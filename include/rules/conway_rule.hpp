@@ -20,6 +20,10 @@ public:
     
     bool apply(bool current, const std::vector<bool>& neighbors) const override;
     
+    bool is_totalistic() const override { return true; }
+    
+    bool apply_count(bool current, int live_neighbors) const override;
+    
     std::unique_ptr<Rule<bool>> clone() const override;
     
     const char* name() const override { return "Conway's Game of Life"; }
@@ -0,0 +1,55 @@
+#ifndef LARGER_THAN_LIFE_RULE_HPP
+#define LARGER_THAN_LIFE_RULE_HPP
+
+#include "rules/rule_base.hpp"
+#include <string>
+
+namespace cell_automaton {
+namespace rules {
+
+/**
+ * Larger than Life family (Golly notation "R5,C0,M1,S34..58,B34..45,NM")
+ * 
+ * Two-state totalistic rule over a range-R neighborhood:
+ * - Live cell survives while its count is within [survive_min, survive_max]
+ * - Dead cell is born while its count is within [birth_min, birth_max]
+ * - With include_center (M1) the cell itself is part of its count
+ * 
+ * Works with Moore, von Neumann and hexagonal neighborhoods of any radius up
+ * to CHUNK_SIZE; the automaton counts Moore and von Neumann neighborhoods in
+ * constant time per cell regardless of R.
+ */
+class LargerThanLifeRule : public Rule<bool> {
+private:
+    Neighborhood shape;
+    bool include_center;
+    int survive_min, survive_max;
+    int birth_min, birth_max;
+    std::string notation_text;
+    
+public:
+    LargerThanLifeRule(Neighborhood nb, bool middle,
+                       int s_min, int s_max, int b_min, int b_max);
+    
+    // Bosco's Rule: R5,C0,M1,S34..58,B34..45,NM
+    static LargerThanLifeRule bosco();
+    
+    bool apply(bool current, const std::vector<bool>& neighbors) const override;
+    
+    Neighborhood neighborhood() const override { return shape; }
+    
+    bool is_totalistic() const override { return true; }
+    
+    bool apply_count(bool current, int live_neighbors) const override;
+    
+    std::unique_ptr<Rule<bool>> clone() const override;
+    
+    const char* name() const override { return "Larger than Life"; }
+    
+    const char* notation() const override { return notation_text.c_str(); }
+};
+
+} // namespace rules
+} // namespace cell_automaton
+
+#endif // LARGER_THAN_LIFE_RULE_HPP
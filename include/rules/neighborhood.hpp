@@ -0,0 +1,65 @@
+#ifndef NEIGHBORHOOD_HPP
+#define NEIGHBORHOOD_HPP
+
+#include <vector>
+#include <utility>
+#include <cstdlib>
+#include <algorithm>
+
+namespace cell_automaton {
+namespace rules {
+
+enum class NeighborhoodKind {
+    Moore,        // Square of side 2R+1
+    VonNeumann,   // Diamond |dx| + |dy| <= R
+    Hexagonal     // Axial hex grid: max(|dx|, |dy|, |dx + dy|) <= R
+};
+
+/**
+ * Shape of the cells a rule looks at, excluding the center cell.
+ *
+ * The automaton reads the neighborhood from the rule once and sizes its chunk
+ * halos from the radius, so rules of any radius up to CHUNK_SIZE run unchanged.
+ */
+struct Neighborhood {
+    NeighborhoodKind kind = NeighborhoodKind::Moore;
+    int radius = 1;
+
+    static Neighborhood moore(int r = 1) { return {NeighborhoodKind::Moore, r}; }
+    static Neighborhood von_neumann(int r = 1) { return {NeighborhoodKind::VonNeumann, r}; }
+    static Neighborhood hexagonal(int r = 1) { return {NeighborhoodKind::Hexagonal, r}; }
+
+    bool contains(int dx, int dy) const {
+        if (dx == 0 && dy == 0) return false;
+        switch (kind) {
+            case NeighborhoodKind::Moore:
+                return std::abs(dx) <= radius && std::abs(dy) <= radius;
+            case NeighborhoodKind::VonNeumann:
+                return std::abs(dx) + std::abs(dy) <= radius;
+            case NeighborhoodKind::Hexagonal:
+                return std::max({std::abs(dx), std::abs(dy), std::abs(dx + dy)}) <= radius;
+        }
+        return false;
+    }
+
+    /**
+     * Offsets (dx, dy) of every neighbor in row-major order. This is the order
+     * in which Rule::apply receives its neighbor states.
+     */
+    std::vector<std::pair<int, int>> offsets() const {
+        std::vector<std::pair<int, int>> result;
+        for (int dy = -radius; dy <= radius; ++dy) {
+            for (int dx = -radius; dx <= radius; ++dx) {
+                if (contains(dx, dy)) result.emplace_back(dx, dy);
+            }
+        }
+        return result;
+    }
+
+    bool operator==(const Neighborhood& other) const = default;
+};
+
+} // namespace rules
+} // namespace cell_automaton
+
+#endif // NEIGHBORHOOD_HPP
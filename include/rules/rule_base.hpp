@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <memory>
+#include "rules/neighborhood.hpp"
 
 namespace cell_automaton {
 namespace rules {
@@ -21,11 +22,32 @@ public:
      * Apply the rule to a cell given its current state and neighbors.
      * 
      * @param current Current state of the cell
-     * @param neighbors Vector of neighbor states (typically 8 for Moore neighborhood)
+     * @param neighbors Vector of neighbor states, in Neighborhood::offsets() order
      * @return New state for the cell
      */
     virtual StateT apply(StateT current, const std::vector<StateT>& neighbors) const = 0;
     
+    /**
+     * Cells this rule reads. Defaults to the 8-cell Moore neighborhood.
+     */
+    virtual Neighborhood neighborhood() const { return Neighborhood::moore(1); }
+    
+    /**
+     * Totalistic rules depend only on the current state and the number of
+     * non-default neighbors. The automaton then feeds them counts computed with
+     * summed-area tables instead of gathering every neighbor state.
+     */
+    virtual bool is_totalistic() const { return false; }
+    
+    /**
+     * Count-based form of apply(); only called when is_totalistic() is true.
+     * 
+     * @param current Current state of the cell
+     * @param live_neighbors Number of neighbors not in the default state
+     * @return New state for the cell
+     */
+    virtual StateT apply_count(StateT current, int /*live_neighbors*/) const { return current; }
+    
     /**
      * Create a copy of this rule. Useful for threading or storing rule configurations.
      * 
@@ -0,0 +1,88 @@
+#ifndef RULE_CONCEPT_HPP
+#define RULE_CONCEPT_HPP
+
+#include <concepts>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+#include "rules/rule_base.hpp"
+#include "rules/neighborhood.hpp"
+
+namespace cell_automaton {
+namespace rules {
+
+// Rules evaluated from the neighbor states, in Neighborhood::offsets() order
+template<typename R, typename StateT>
+concept NeighborRule = requires(const R& rule, StateT current, std::span<const StateT> neighbors) {
+    { rule.apply(current, neighbors) } -> std::convertible_to<StateT>;
+};
+
+// Rules evaluated from the number of non-default neighbors
+template<typename R, typename StateT>
+concept CountRule = requires(const R& rule, StateT current, int live_neighbors) {
+    { rule.apply_count(current, live_neighbors) } -> std::convertible_to<StateT>;
+};
+
+/**
+ * Rule types a CellularAutomaton can be instantiated with. Besides
+ * neighborhood(), a rule provides at least one of
+ *
+ *     StateT apply(StateT current, std::span<const StateT> neighbors) const;
+ *     StateT apply_count(StateT current, int live_neighbors) const;
+ *
+ * Rules are stored by value and called directly, so a plain functor is
+ * inlined into the stepping kernels. Wrap a virtual Rule in AnyRule.
+ */
+template<typename R, typename StateT>
+concept CellRule = std::move_constructible<R> &&
+    requires(const R& rule) {
+        { rule.neighborhood() } -> std::convertible_to<Neighborhood>;
+    } &&
+    (NeighborRule<R, StateT> || CountRule<R, StateT>);
+
+/**
+ * Whether the automaton feeds the rule neighbor counts. Rules may decide at
+ * run time with is_totalistic(); otherwise a rule with apply_count() is.
+ */
+template<typename StateT, typename R>
+bool is_totalistic_rule(const R& rule) {
+    if constexpr (requires { { rule.is_totalistic() } -> std::convertible_to<bool>; }) {
+        return rule.is_totalistic();
+    } else {
+        return CountRule<R, StateT>;
+    }
+}
+
+/**
+ * Type-erased adapter over the virtual Rule interface, the default rule type
+ * of CellularAutomaton. Every cell pays a virtual call; rules written as
+ * CellRule functors avoid it.
+ */
+template<typename StateT>
+class AnyRule {
+private:
+    std::unique_ptr<Rule<StateT>> rule;
+
+public:
+    explicit AnyRule(std::unique_ptr<Rule<StateT>> r) : rule(std::move(r)) {}
+    AnyRule(const AnyRule& other) : rule(other.rule->clone()) {}
+    AnyRule(AnyRule&&) noexcept = default;
+    AnyRule& operator=(AnyRule other) noexcept {
+        rule = std::move(other.rule);
+        return *this;
+    }
+
+    Neighborhood neighborhood() const { return rule->neighborhood(); }
+    bool is_totalistic() const { return rule->is_totalistic(); }
+    StateT apply_count(StateT current, int live_neighbors) const { return rule->apply_count(current, live_neighbors); }
+    // Takes the vector the automaton gathers into, so nothing is copied
+    StateT apply(StateT current, const std::vector<StateT>& neighbors) const { return rule->apply(current, neighbors); }
+
+    const Rule<StateT>& get() const { return *rule; }
+};
+
+} // namespace rules
+} // namespace cell_automaton
+
+#endif // RULE_CONCEPT_HPP
@@ -7,7 +7,6 @@
 #include <vector>
 #include <functional>
 #include <string>
-#include <cstdlib>
 #include <cmath>
 
 using namespace cell_automaton;
@@ -37,6 +36,8 @@ struct BenchmarkResult {
     double max_time_ms;
     double std_dev_ms;
     int final_chunks;
+    MemoryUsage final_memory;
+    StrategyStats final_strategies;
     double generations_per_second;
     double cells_evaluated_estimate;
     
@@ -50,6 +51,11 @@ struct BenchmarkResult {
         std::cout << "│ Min/Max time:    " << std::setw(10) << min_time_ms << " / " << std::setw(10) << max_time_ms << " ms        │\n";
         std::cout << "│ Std deviation:   " << std::setw(10) << std_dev_ms << " ms                  │\n";
         std::cout << "│ Final chunks:    " << std::setw(10) << final_chunks << "                        │\n";
+        std::cout << "│ Sp/De/Frozen:    " << std::setw(6) << final_memory.sparse_chunks << " / " << std::setw(6) << final_memory.dense_chunks
+                  << " / " << std::setw(6) << final_memory.frozen_chunks << "           │\n";
+        std::cout << "│ Memory:          " << std::setw(10) << final_memory.total_bytes() / 1024.0 << " KB                  │\n";
+        std::cout << "│ Step sp/de/memo: " << std::setw(6) << final_strategies.sparse_chunks << " / " << std::setw(6) << final_strategies.dense_chunks
+                  << " / " << std::setw(6) << final_strategies.memoized_chunks << "           │\n";
         std::cout << "│ Gen/sec:         " << std::setw(10) << generations_per_second << "                        │\n";
         std::cout << "│ Est cells/gen:   " << std::setw(10) << (int)cells_evaluated_estimate << "                        │\n";
         std::cout << "╰─────────────────────────────────────────────────────────────────╯\n\n";
@@ -79,6 +85,8 @@ public:
         times.reserve(config.benchmark_runs);
         
         int final_chunks = 0;
+        MemoryUsage final_memory;
+        StrategyStats final_strategies;
         
         // Warmup runs
         if (config.verbose) {
@@ -110,6 +118,8 @@ public:
             times.push_back(duration.count() / 1000.0); // Convert to milliseconds
             
             final_chunks = ca.get_active_chunks();
+            final_memory = ca.memory_usage();
+            final_strategies = ca.get_strategy_stats();
             
             if (config.verbose) {
                 std::cout << "  Run " << (run + 1) << ": " << times.back() << " ms\n";
@@ -142,6 +152,8 @@ public:
         result.max_time_ms = max_time;
         result.std_dev_ms = std_dev;
         result.final_chunks = final_chunks;
+        result.final_memory = final_memory;
+        result.final_strategies = final_strategies;
         result.generations_per_second = gen_per_sec;
         result.cells_evaluated_estimate = cells_estimate;
         
@@ -181,28 +193,40 @@ public:
 // Pattern Initialization Functions
 // ============================================================================
 auto init_small_soup = [](CellularAutomaton<bool>& ca) {
-    std::srand(42);
-    patterns::create_random_soup(ca, -25, -25, 50, 50, 0.3);
+    patterns::create_random_soup(ca, -25, -25, 50, 50, 0.3, 42);
 };
 
 auto init_medium_soup = [](CellularAutomaton<bool>& ca) {
-    std::srand(42);
-    patterns::create_random_soup(ca, -100, -100, 200, 200, 0.25);
+    patterns::create_random_soup(ca, -100, -100, 200, 200, 0.25, 42);
 };
 
 auto init_large_soup = [](CellularAutomaton<bool>& ca) {
-    std::srand(42);
-    patterns::create_random_soup(ca, -250, -250, 500, 500, 0.2);
+    patterns::create_random_soup(ca, -250, -250, 500, 500, 0.2, 42);
 };
 
 auto init_sparse_pattern = [](CellularAutomaton<bool>& ca) {
-    std::srand(42);
-    patterns::create_random_soup(ca, -500, -500, 1000, 1000, 0.05);
+    patterns::create_random_soup(ca, -500, -500, 1000, 1000, 0.05, 42);
 };
 
 auto init_dense_pattern = [](CellularAutomaton<bool>& ca) {
-    std::srand(42);
-    patterns::create_random_soup(ca, -50, -50, 100, 100, 0.8);
+    patterns::create_random_soup(ca, -50, -50, 100, 100, 0.8, 42);
+};
+
+// Same soups, advanced several generations per pass
+auto init_medium_soup_blocked = [](CellularAutomaton<bool>& ca) {
+    ca.set_temporal_blocking(0);
+    init_medium_soup(ca);
+};
+
+auto init_dense_pattern_blocked = [](CellularAutomaton<bool>& ca) {
+    ca.set_temporal_blocking(0);
+    init_dense_pattern(ca);
+};
+
+// Same soup folded into a D4-symmetric one; only a quadrant is stepped
+auto init_medium_soup_d4 = [](CellularAutomaton<bool>& ca) {
+    ca.set_symmetry(Symmetry::D4);
+    init_medium_soup(ca);
 };
 
 auto init_glider_fleet = [](CellularAutomaton<bool>& ca) {
@@ -242,6 +266,9 @@ int main(int argc, char* argv[]) {
     runner.run_benchmark(BenchmarkConfig("Medium Random Soup (50 gen)", 50, verbose), init_medium_soup);
     runner.run_benchmark(BenchmarkConfig("Large Sparse Pattern (20 gen)", 20, verbose), init_sparse_pattern);
     runner.run_benchmark(BenchmarkConfig("Dense Pattern (50 gen)", 50, verbose), init_dense_pattern);
+    runner.run_benchmark(BenchmarkConfig("Medium Soup, Blocked (50 gen)", 50, verbose), init_medium_soup_blocked);
+    runner.run_benchmark(BenchmarkConfig("Dense Pattern, Blocked (50 gen)", 50, verbose), init_dense_pattern_blocked);
+    runner.run_benchmark(BenchmarkConfig("Medium Soup, D4 (50 gen)", 50, verbose), init_medium_soup_d4);
     
     // Long-running tests
     runner.run_benchmark(BenchmarkConfig("Gosper Gun (500 gen)", 500, verbose), init_gosper_gun);
@@ -0,0 +1,634 @@
+#include "cell_automaton/cellular_automaton_impl.hpp"
+#include "cell_automaton/neighbor_counter.hpp"
+#include "rules/conway_rule.hpp"
+#include "rules/larger_than_life_rule.hpp"
+#include "patterns/soup_rng.hpp"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <span>
+
+using namespace cell_automaton;
+
+// ============================================================================
+// Micro Benchmark Harness
+// ============================================================================
+// Each benchmark times one primitive in isolation and reports ns per operation,
+// taking the fastest of several repetitions to filter out scheduling noise.
+//
+//   micro_benchmark [filter] [-q]
+//
+// Only benchmarks whose name contains `filter` run; -q shortens every timing.
+
+struct MicroConfig {
+    std::string filter;
+    double min_time_ms = 100.0;
+    int repetitions = 5;
+};
+
+struct MicroResult {
+    std::string name;
+    double ns_per_op;
+    size_t ops;
+};
+
+// Keeps the compiler from discarding a computed value
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+class MicroRunner {
+private:
+    MicroConfig config;
+    std::vector<MicroResult> results;
+
+public:
+    explicit MicroRunner(MicroConfig c) : config(std::move(c)) {}
+
+    bool enabled(const std::string& name) const {
+        return name.find(config.filter) != std::string::npos;
+    }
+
+    /**
+     * Time body(), which performs ops_per_call operations, until min_time_ms
+     * has elapsed; setup() runs untimed before every call.
+     */
+    template<typename Setup, typename Body>
+    void run(const std::string& name, size_t ops_per_call, Setup setup, Body body) {
+        if (!enabled(name)) return;
+
+        double best = 1e300;
+        size_t total_ops = 0;
+        for (int rep = 0; rep < config.repetitions; ++rep) {
+            double elapsed_ns = 0.0;
+            size_t ops = 0;
+            while (elapsed_ns < config.min_time_ms * 1e6 / config.repetitions) {
+                setup();
+                auto start = std::chrono::steady_clock::now();
+                body();
+                auto end = std::chrono::steady_clock::now();
+                elapsed_ns += std::chrono::duration<double, std::nano>(end - start).count();
+                ops += ops_per_call;
+            }
+            best = std::min(best, elapsed_ns / ops);
+            total_ops += ops;
+        }
+
+        results.push_back({name, best, total_ops});
+        std::cout << std::left << std::setw(60) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << best << " ns/op" << std::setw(14) << total_ops << " ops\n";
+    }
+
+    template<typename Body>
+    void run(const std::string& name, size_t ops_per_call, Body body) {
+        run(name, ops_per_call, [] {}, body);
+    }
+
+    size_t count() const { return results.size(); }
+};
+
+// ============================================================================
+// Automaton Internals
+// ============================================================================
+// CellularAutomaton befriends this struct so the chunk index and single
+// stepping kernels can be timed without going through step().
+
+struct MicroBenchmarkAccess {
+    template<typename Automaton>
+    static auto chunk_coord(int32_t x, int32_t y) { return Automaton::get_chunk_coord(x, y); }
+    template<typename Automaton>
+    static auto local_coord(int32_t x, int32_t y) { return Automaton::get_local_coord(x, y); }
+    
+    // Candidates of the next generation; the step is never finished, so the
+    // automaton is only good for kernel calls afterwards
+    template<typename StateT, typename RuleT>
+    static const auto& begin_step(CellularAutomaton<StateT, RuleT>& ca) {
+        ca.begin_step();
+        return ca.candidates;
+    }
+    template<typename StateT, typename RuleT, typename Candidate>
+    static size_t load_tile(CellularAutomaton<StateT, RuleT>& ca, const Candidate& candidate) {
+        return ca.load_tile(candidate, ca.tile.get(), ca.halo);
+    }
+    // Dense kernel over the last loaded tile
+    template<typename StateT, typename RuleT>
+    static size_t compute_tile(CellularAutomaton<StateT, RuleT>& ca) {
+        return ca.compute_tile();
+    }
+    template<typename StateT, typename RuleT, typename Candidate>
+    static size_t compute_scatter(CellularAutomaton<StateT, RuleT>& ca, const Candidate& candidate) {
+        size_t live_cells = 0;
+        return ca.compute_scatter(candidate, live_cells);
+    }
+};
+
+// ============================================================================
+// Fixtures
+// ============================================================================
+template<typename StateT> const char* state_name();
+template<> const char* state_name<bool>() { return "bool"; }
+template<> const char* state_name<uint8_t>() { return "uint8_t"; }
+template<> const char* state_name<int>() { return "int"; }
+
+// Non-default state used to fill fixtures
+template<typename StateT>
+StateT live_state(patterns::SoupRng& rng) {
+    if constexpr (std::is_same_v<StateT, bool>) {
+        return true;
+    } else {
+        return static_cast<StateT>(1 + rng.next() % 100);
+    }
+}
+
+inline bool chance(patterns::SoupRng& rng, double p) {
+    return double(rng.next() >> 11) * 0x1.0p-53 < p;
+}
+
+inline std::string density_name(double density) {
+    std::ostringstream out;
+    out << "d=" << density;
+    return out.str();
+}
+
+/**
+ * Chunk filled at the given density and forced into the requested storage
+ * mode, whatever its density would pick on its own.
+ */
+template<typename StateT>
+Chunk<StateT> make_chunk(double density, bool dense, uint64_t seed) {
+    patterns::SoupRng rng(seed);
+    Chunk<StateT> chunk;
+    chunk.convert_to_dense();
+    for (int y = 0; y < static_cast<int>(CHUNK_SIZE); ++y) {
+        for (int x = 0; x < static_cast<int>(CHUNK_SIZE); ++x) {
+            if (chance(rng, density)) chunk.set_cell(x, y, live_state<StateT>(rng));
+        }
+    }
+    if (dense) {
+        chunk.convert_to_dense();
+    } else {
+        chunk.convert_to_sparse();
+    }
+    return chunk;
+}
+
+// Random local coordinates, packed as y * CHUNK_SIZE + x
+inline std::vector<uint16_t> make_local_coords(size_t count, uint64_t seed) {
+    patterns::SoupRng rng(seed);
+    std::vector<uint16_t> coords(count);
+    for (uint16_t& key : coords) {
+        key = static_cast<uint16_t>(rng.next() % (CHUNK_SIZE * CHUNK_SIZE));
+    }
+    return coords;
+}
+
+// Random world coordinates in [-extent, extent)^2
+inline std::vector<std::pair<int32_t, int32_t>> make_world_coords(size_t count, int32_t extent, uint64_t seed) {
+    patterns::SoupRng rng(seed);
+    std::vector<std::pair<int32_t, int32_t>> coords(count);
+    for (auto& [x, y] : coords) {
+        x = static_cast<int32_t>(rng.next() % (2 * uint64_t(extent))) - extent;
+        y = static_cast<int32_t>(rng.next() % (2 * uint64_t(extent))) - extent;
+    }
+    return coords;
+}
+
+// Life-like rule over any state type: non-default cells count as live and
+// births take state 1
+template<typename StateT>
+class LifeLikeRule : public rules::Rule<StateT> {
+public:
+    StateT apply(StateT current, const std::vector<StateT>& neighbors) const override {
+        int live_neighbors = 0;
+        for (StateT neighbor : neighbors) {
+            live_neighbors += neighbor != StateT{};
+        }
+        return apply_count(current, live_neighbors);
+    }
+
+    bool is_totalistic() const override { return true; }
+
+    StateT apply_count(StateT current, int live_neighbors) const override {
+        if (current != StateT{}) {
+            return (live_neighbors == 2 || live_neighbors == 3) ? current : StateT{};
+        }
+        return live_neighbors == 3 ? StateT(1) : StateT{};
+    }
+
+    std::unique_ptr<rules::Rule<StateT>> clone() const override {
+        return std::make_unique<LifeLikeRule>(*this);
+    }
+
+    const char* name() const override { return "Life-like"; }
+};
+
+template<typename StateT>
+std::unique_ptr<rules::Rule<StateT>> make_default_rule() {
+    if constexpr (std::is_same_v<StateT, bool>) {
+        return std::make_unique<rules::ConwayRule>();
+    } else {
+        return std::make_unique<LifeLikeRule<StateT>>();
+    }
+}
+
+// Fill `chunks` x `chunks` chunks around the origin at density
+template<typename StateT, typename RuleT>
+void fill_world(CellularAutomaton<StateT, RuleT>& ca, int chunks, double density, uint64_t seed) {
+    patterns::SoupRng rng(seed);
+    const int32_t extent = chunks * static_cast<int32_t>(CHUNK_SIZE) / 2;
+    for (int32_t y = -extent; y < extent; ++y) {
+        for (int32_t x = -extent; x < extent; ++x) {
+            if (chance(rng, density)) ca.set_cell(x, y, live_state<StateT>(rng));
+        }
+    }
+    ca.publish();
+}
+
+template<typename StateT>
+std::unique_ptr<CellularAutomaton<StateT>> make_world(int chunks, double density, uint64_t seed) {
+    auto ca = std::make_unique<CellularAutomaton<StateT>>(make_default_rule<StateT>(), StateT{});
+    fill_world(*ca, chunks, density, seed);
+    return ca;
+}
+
+// The life-like rule evaluated from neighbor states, as a virtual Rule and as
+// a functor; neither is totalistic, so every evaluated cell calls apply()
+template<typename StateT, typename Neighbors>
+StateT life_like_next(StateT current, const Neighbors& neighbors) {
+    int live_neighbors = 0;
+    for (StateT neighbor : neighbors) {
+        live_neighbors += neighbor != StateT{};
+    }
+    if (current != StateT{}) {
+        return (live_neighbors == 2 || live_neighbors == 3) ? current : StateT{};
+    }
+    return live_neighbors == 3 ? StateT(1) : StateT{};
+}
+
+template<typename StateT>
+class GatherLifeRule : public rules::Rule<StateT> {
+public:
+    StateT apply(StateT current, const std::vector<StateT>& neighbors) const override {
+        return life_like_next(current, neighbors);
+    }
+
+    std::unique_ptr<rules::Rule<StateT>> clone() const override {
+        return std::make_unique<GatherLifeRule>(*this);
+    }
+};
+
+template<typename StateT>
+struct GatherLifeFunctor {
+    rules::Neighborhood neighborhood() const { return rules::Neighborhood::moore(1); }
+    StateT apply(StateT current, std::span<const StateT> neighbors) const {
+        return life_like_next(current, neighbors);
+    }
+};
+
+// ============================================================================
+// Chunk Benchmarks
+// ============================================================================
+constexpr size_t ACCESSES = 4096;
+
+template<typename StateT>
+void bench_chunk(MicroRunner& runner) {
+    const std::string type = state_name<StateT>();
+    const auto coords = make_local_coords(ACCESSES, 1);
+
+    for (bool dense : {false, true}) {
+        const std::string mode = dense ? "dense" : "sparse";
+        // Densities each mode keeps under set_cell's hysteresis
+        const std::vector<double> densities = dense ? std::vector<double>{0.2, 0.5, 0.9}
+                                                    : std::vector<double>{0.01, 0.05, 0.2};
+
+        for (double density : densities) {
+            const std::string params = "/" + mode + "/" + type + "/" + density_name(density);
+            Chunk<StateT> chunk = make_chunk<StateT>(density, dense, 2);
+
+            runner.run("chunk/get_cell" + params, ACCESSES, [&] {
+                StateT sum{};
+                for (uint16_t key : coords) {
+                    sum ^= chunk.get_cell(key % CHUNK_SIZE, key / CHUNK_SIZE);
+                }
+                do_not_optimize(sum);
+            });
+
+            // Write each cell and restore it, so density and mode stay put
+            runner.run("chunk/set_cell" + params, 2 * ACCESSES, [&] {
+                for (uint16_t key : coords) {
+                    const int x = key % CHUNK_SIZE, y = key / CHUNK_SIZE;
+                    const StateT before = chunk.get_cell(x, y);
+                    chunk.set_cell(x, y, before == StateT{} ? StateT(1) : StateT{});
+                    chunk.set_cell(x, y, before);
+                }
+                do_not_optimize(chunk);
+            });
+
+            // The whole chunk, as load_tile copies the center of a block, and
+            // a one-cell column, as it copies the side of a neighbor
+            constexpr size_t REGIONS = 64;
+            auto region = std::make_unique<StateT[]>(CHUNK_SIZE * CHUNK_SIZE);
+            runner.run("chunk/copy_region/full" + params, REGIONS, [&] {
+                size_t copied = 0;
+                for (size_t i = 0; i < REGIONS; ++i) {
+                    copied += chunk.copy_region(0, 0, CHUNK_SIZE, CHUNK_SIZE, region.get(), CHUNK_SIZE);
+                }
+                do_not_optimize(copied);
+            });
+            runner.run("chunk/copy_region/column" + params, REGIONS, [&] {
+                size_t copied = 0;
+                for (size_t i = 0; i < REGIONS; ++i) {
+                    copied += chunk.copy_region(CHUNK_SIZE - 1, 0, 1, CHUNK_SIZE, region.get(), 1);
+                }
+                do_not_optimize(copied);
+            });
+        }
+    }
+
+    // Conversions run on fresh copies; copying is untimed
+    constexpr size_t COPIES = 64;
+    for (double density : {0.01, 0.1, 0.3, 0.6}) {
+        const std::string params = "/" + type + "/" + density_name(density);
+        const Chunk<StateT> sparse = make_chunk<StateT>(density, false, 3);
+        const Chunk<StateT> dense = make_chunk<StateT>(density, true, 3);
+        std::vector<Chunk<StateT>> work(COPIES);
+
+        runner.run("chunk/convert_to_dense" + params, COPIES,
+                   [&] { std::fill(work.begin(), work.end(), sparse); },
+                   [&] { for (auto& chunk : work) chunk.convert_to_dense(); do_not_optimize(work); });
+        runner.run("chunk/convert_to_sparse" + params, COPIES,
+                   [&] { std::fill(work.begin(), work.end(), dense); },
+                   [&] { for (auto& chunk : work) chunk.convert_to_sparse(); do_not_optimize(work); });
+    }
+}
+
+// ============================================================================
+// Chunk Index Benchmarks
+// ============================================================================
+template<typename StateT>
+void bench_index(MicroRunner& runner) {
+    using Automaton = CellularAutomaton<StateT>;
+    const std::string type = state_name<StateT>();
+
+    {
+        const auto coords = make_world_coords(ACCESSES, 1 << 20, 4);
+        runner.run("index/get_chunk_coord/" + type, ACCESSES, [&] {
+            int64_t sum = 0;
+            for (auto [x, y] : coords) {
+                auto [cx, cy] = MicroBenchmarkAccess::chunk_coord<Automaton>(x, y);
+                auto [lx, ly] = MicroBenchmarkAccess::local_coord<Automaton>(x, y);
+                sum += cx ^ cy ^ lx ^ ly;
+            }
+            do_not_optimize(sum);
+        });
+    }
+
+    for (int chunks : {1, 8, 32}) {
+        for (double density : {0.05, 0.3}) {
+            const std::string params = "/" + type + "/" + std::to_string(chunks * chunks) + "chunks/" + density_name(density);
+            if (!runner.enabled("index/get_cell" + params) && !runner.enabled("index/set_cell" + params)) continue;
+
+            auto ca = make_world<StateT>(chunks, density, 5);
+            const int32_t extent = chunks * static_cast<int32_t>(CHUNK_SIZE) / 2;
+            const auto coords = make_world_coords(ACCESSES, extent, 6);
+
+            runner.run("index/get_cell" + params, ACCESSES, [&] {
+                StateT sum{};
+                for (auto [x, y] : coords) sum ^= ca->get_cell(x, y);
+                do_not_optimize(sum);
+            });
+
+            // Existing chunks: the lookup half of get_or_create_chunk
+            runner.run("index/set_cell" + params, 2 * ACCESSES, [&] {
+                for (auto [x, y] : coords) {
+                    const StateT before = ca->get_cell(x, y);
+                    ca->set_cell(x, y, before == StateT{} ? StateT(1) : StateT{});
+                    ca->set_cell(x, y, before);
+                }
+            });
+        }
+    }
+
+    // New chunks: the create half of get_or_create_chunk, one cell per chunk
+    for (int chunks : {8, 32}) {
+        const std::string name = "index/set_cell_new_chunk/" + type + "/" + std::to_string(chunks * chunks) + "chunks";
+        std::unique_ptr<Automaton> ca;
+        runner.run(name, size_t(chunks) * chunks,
+                   [&] { ca = std::make_unique<Automaton>(make_default_rule<StateT>(), StateT{}); },
+                   [&] {
+                       for (int cy = 0; cy < chunks; ++cy) {
+                           for (int cx = 0; cx < chunks; ++cx) {
+                               ca->set_cell(cx * int32_t(CHUNK_SIZE), cy * int32_t(CHUNK_SIZE), StateT(1));
+                           }
+                       }
+                   });
+    }
+}
+
+// ============================================================================
+// Neighbor Counter Benchmarks
+// ============================================================================
+// ns per chunk cell; the counter's cost should not grow with the radius.
+
+void bench_neighbor_counter(MicroRunner& runner) {
+    constexpr int size = static_cast<int>(CHUNK_SIZE);
+    for (bool moore : {true, false}) {
+        for (int radius : {1, 2, 4, 8}) {
+            const std::string name = std::string("counter/count/") + (moore ? "moore" : "von_neumann")
+                                   + "/r=" + std::to_string(radius);
+            if (!runner.enabled(name)) continue;
+
+            const rules::Neighborhood nb = moore ? rules::Neighborhood::moore(radius)
+                                                 : rules::Neighborhood::von_neumann(radius);
+            const int stride = size + 2 * radius;
+            patterns::SoupRng rng(8);
+            std::vector<uint8_t> live(size_t(stride) * stride);
+            for (uint8_t& cell : live) cell = chance(rng, 0.3);
+            std::vector<int32_t> counts(CHUNK_SIZE * CHUNK_SIZE);
+
+            NeighborCounter counter;
+            runner.run(name, CHUNK_SIZE * CHUNK_SIZE, [&] {
+                counter.count(live.data(), size, radius, nb, counts.data());
+                do_not_optimize(counts.data());
+            });
+        }
+    }
+}
+
+// ============================================================================
+// Stepping Kernel Benchmarks
+// ============================================================================
+// ns per chunk for the pieces step() picks between: loading a tile from the
+// 3x3 block, the dense kernel over a loaded tile, and the scatter kernel that
+// sparse blocks use instead of a tile.
+
+template<typename StateT>
+void bench_kernels(MicroRunner& runner) {
+    const std::string type = state_name<StateT>();
+    constexpr int CHUNKS = 8;
+
+    for (double density : {0.05, 0.3}) {
+        const std::string name = "kernel/load_tile/" + type + "/" + density_name(density);
+        if (!runner.enabled(name)) continue;
+
+        auto ca = make_world<StateT>(CHUNKS, density, 9);
+        const auto& candidates = MicroBenchmarkAccess::begin_step(*ca);
+        runner.run(name, candidates.size(), [&] {
+            size_t live_cells = 0;
+            for (const auto& candidate : candidates) live_cells += MicroBenchmarkAccess::load_tile(*ca, candidate);
+            do_not_optimize(live_cells);
+        });
+    }
+
+    // The same fully populated tile every call
+    for (double density : {0.1, 0.3, 0.5}) {
+        const std::string name = "kernel/dense/" + type + "/" + density_name(density);
+        if (!runner.enabled(name)) continue;
+
+        auto ca = make_world<StateT>(CHUNKS, density, 10);
+        const auto& candidates = MicroBenchmarkAccess::begin_step(*ca);
+        const auto center = std::find_if(candidates.begin(), candidates.end(),
+                                         [](const auto& candidate) { return candidate.coord == std::make_pair(0, 0); });
+        MicroBenchmarkAccess::load_tile(*ca, *center);
+        runner.run(name, 1, [&] { do_not_optimize(MicroBenchmarkAccess::compute_tile(*ca)); });
+    }
+
+    // Densities whose blocks stay within the sparse work budget
+    for (double density : {0.002, 0.005, 0.01}) {
+        const std::string name = "kernel/scatter/" + type + "/" + density_name(density);
+        if (!runner.enabled(name)) continue;
+
+        auto ca = make_world<StateT>(CHUNKS, density, 11);
+        const auto& candidates = MicroBenchmarkAccess::begin_step(*ca);
+        runner.run(name, candidates.size(), [&] {
+            size_t population = 0;
+            for (const auto& candidate : candidates) population += MicroBenchmarkAccess::compute_scatter(*ca, candidate);
+            do_not_optimize(population);
+        });
+    }
+}
+
+// ============================================================================
+// Rule Benchmarks
+// ============================================================================
+template<typename StateT>
+void bench_rule(MicroRunner& runner, const std::string& name, const rules::Rule<StateT>& rule) {
+    const std::string type = state_name<StateT>();
+    const auto offsets = rule.neighborhood().offsets();
+    constexpr size_t INPUTS = 1024;
+
+    for (double density : {0.1, 0.4}) {
+        const std::string params = "/" + name + "/" + type + "/" + density_name(density);
+        if (!runner.enabled("rule/apply" + params) && !runner.enabled("rule/apply_count" + params)) continue;
+
+        patterns::SoupRng rng(7);
+        std::vector<StateT> centers(INPUTS);
+        std::vector<std::vector<StateT>> neighbors(INPUTS, std::vector<StateT>(offsets.size()));
+        std::vector<int> counts(INPUTS);
+        for (size_t i = 0; i < INPUTS; ++i) {
+            centers[i] = chance(rng, density) ? live_state<StateT>(rng) : StateT{};
+            for (size_t n = 0; n < offsets.size(); ++n) {
+                neighbors[i][n] = chance(rng, density) ? live_state<StateT>(rng) : StateT{};
+                counts[i] += neighbors[i][n] != StateT{};
+            }
+        }
+
+        runner.run("rule/apply" + params, INPUTS, [&] {
+            StateT sum{};
+            for (size_t i = 0; i < INPUTS; ++i) sum ^= rule.apply(centers[i], neighbors[i]);
+            do_not_optimize(sum);
+        });
+
+        if (rule.is_totalistic()) {
+            runner.run("rule/apply_count" + params, INPUTS, [&] {
+                StateT sum{};
+                for (size_t i = 0; i < INPUTS; ++i) sum ^= rule.apply_count(centers[i], counts[i]);
+                do_not_optimize(sum);
+            });
+        }
+    }
+}
+
+void bench_rules(MicroRunner& runner) {
+    bench_rule<bool>(runner, "conway", rules::ConwayRule());
+    bench_rule<bool>(runner, "bosco", rules::LargerThanLifeRule::bosco());
+    bench_rule<bool>(runner, "ltl_vn3", rules::LargerThanLifeRule(rules::Neighborhood::von_neumann(3), false, 5, 9, 6, 8));
+    bench_rule<bool>(runner, "life_like", LifeLikeRule<bool>());
+    bench_rule<uint8_t>(runner, "life_like", LifeLikeRule<uint8_t>());
+    bench_rule<int>(runner, "life_like", LifeLikeRule<int>());
+}
+
+// ============================================================================
+// Rule Dispatch Benchmarks
+// ============================================================================
+// Cells evaluated by the dense kernel per second for a rule that is not
+// totalistic, called through AnyRule and as a functor rule type.
+
+template<typename StateT, typename RuleT>
+void bench_step_rule(MicroRunner& runner, const std::string& name, const RuleT& rule) {
+    constexpr int CHUNKS = 4;
+    constexpr int GENERATIONS = 4;
+    std::unique_ptr<CellularAutomaton<StateT, RuleT>> ca;
+    runner.run(name, size_t(CHUNKS) * CHUNKS * CHUNK_SIZE * CHUNK_SIZE * GENERATIONS,
+               [&] {
+                   ca = std::make_unique<CellularAutomaton<StateT, RuleT>>(rule, StateT{});
+                   ca->set_adaptive(false);
+                   fill_world(*ca, CHUNKS, 0.35, 42);
+               },
+               [&] { ca->run(GENERATIONS); });
+}
+
+template<typename StateT>
+void bench_step_dispatch(MicroRunner& runner) {
+    const std::string type = state_name<StateT>();
+    bench_step_rule<StateT>(runner, "step/rule_dispatch/virtual/" + type,
+                            rules::AnyRule<StateT>(std::make_unique<GatherLifeRule<StateT>>()));
+    bench_step_rule<StateT>(runner, "step/rule_dispatch/functor/" + type, GatherLifeFunctor<StateT>());
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char* argv[]) {
+    MicroConfig config;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-q") == 0) {
+            config.min_time_ms = 10.0;
+            config.repetitions = 3;
+        } else {
+            config.filter = argv[i];
+        }
+    }
+
+    std::cout << "=== Cellular Automaton Micro Benchmarks ===\n\n";
+    MicroRunner runner(config);
+
+    bench_chunk<bool>(runner);
+    bench_chunk<uint8_t>(runner);
+    bench_chunk<int>(runner);
+
+    bench_index<bool>(runner);
+    bench_index<uint8_t>(runner);
+    bench_index<int>(runner);
+
+    bench_neighbor_counter(runner);
+
+    bench_kernels<bool>(runner);
+    bench_kernels<uint8_t>(runner);
+    bench_kernels<int>(runner);
+
+    bench_rules(runner);
+
+    bench_step_dispatch<bool>(runner);
+    bench_step_dispatch<uint8_t>(runner);
+    bench_step_dispatch<int>(runner);
+
+    std::cout << "\n" << runner.count() << " benchmarks\n";
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include "cell_automaton/density_pyramid.hpp"
+#include <algorithm>
+
+// ============================================================================
+// Level table
+// ============================================================================
+
+DensityPyramid::Level& DensityPyramid::Level::operator=(const Level& other) {
+    // Vector assignment never shrinks; after other shrank, take a fitting table
+    if (slots.capacity() > other.slots.size() * 2) {
+        std::vector<Slot>().swap(slots);
+    }
+    slots = other.slots;
+    used = other.used;
+    return *this;
+}
+
+uint64_t DensityPyramid::Level::get(uint64_t key) const {
+    if (used == 0) return 0;
+    
+    const size_t mask = slots.size() - 1;
+    for (size_t i = home(key); slots[i].count != 0; i = (i + 1) & mask) {
+        if (slots[i].key == key) return slots[i].count;
+    }
+    return 0;
+}
+
+void DensityPyramid::Level::add(uint64_t key, int64_t delta) {
+    if ((used + 1) * 4 > slots.size() * 3) rebuild(std::max<size_t>(16, slots.size() * 2));
+    
+    const size_t mask = slots.size() - 1;
+    size_t i = home(key);
+    while (slots[i].count != 0 && slots[i].key != key) {
+        i = (i + 1) & mask;
+    }
+    if (slots[i].count == 0) {
+        slots[i].key = key;
+        ++used;
+    }
+    slots[i].count += delta;
+    if (slots[i].count == 0) {
+        erase_at(i);
+        // Shrinking to a quarter leaves the table at most half full, far
+        // from the growth threshold
+        if (slots.size() > 16 && used * 8 < slots.size()) rebuild(slots.size() / 4);
+    }
+}
+
+void DensityPyramid::Level::erase_at(size_t index) {
+    const size_t mask = slots.size() - 1;
+    slots[index].count = 0;
+    --used;
+    
+    // Pull later entries of the cluster back unless that would move them
+    // before their home slot
+    size_t hole = index;
+    for (size_t i = (index + 1) & mask; slots[i].count != 0; i = (i + 1) & mask) {
+        const size_t h = home(slots[i].key);
+        const bool movable = hole <= i ? (h <= hole || h > i) : (h <= hole && h > i);
+        if (movable) {
+            slots[hole] = slots[i];
+            slots[i].count = 0;
+            hole = i;
+        }
+    }
+}
+
+void DensityPyramid::Level::rebuild(size_t size) {
+    std::vector<Slot> old(std::max<size_t>(16, size));
+    old.swap(slots);
+    used = 0;
+    for (const Slot& slot : old) {
+        if (slot.count != 0) add(slot.key, int64_t(slot.count));
+    }
+}
+
+void DensityPyramid::Level::clear() {
+    std::fill(slots.begin(), slots.end(), Slot{});
+    used = 0;
+}
+
+void DensityPyramid::Level::release() {
+    std::vector<Slot>().swap(slots);
+    used = 0;
+}
+
+// ============================================================================
+// Pyramid
+// ============================================================================
+
+void DensityPyramid::add(int32_t chunk_x, int32_t chunk_y, int64_t delta) {
+    if (delta == 0) return;
+    
+    population += delta;
+    for (int level = 0; level < LEVELS; ++level) {
+        // Arithmetic shift floors negative coordinates
+        levels[level].add(pack(chunk_x >> level, chunk_y >> level), delta);
+    }
+}
+
+uint64_t DensityPyramid::count(int level, int32_t node_x, int32_t node_y) const {
+    return levels[level].get(pack(node_x, node_y));
+}
+
+void DensityPyramid::clear() {
+    for (auto& level : levels) {
+        level.clear();
+    }
+    population = 0;
+}
+
+void DensityPyramid::release() {
+    for (auto& level : levels) {
+        level.release();
+    }
+    population = 0;
+}
+
+void DensityPyramid::descend_edge(int axis, bool want_max, std::vector<NodeCoord>& out) const {
+    auto coord = [axis](const NodeCoord& c) { return axis == 0 ? c.first : c.second; };
+    auto better = [want_max](int32_t a, int32_t b) { return want_max ? a > b : a < b; };
+    
+    // Top level: every node is a candidate
+    std::vector<NodeCoord> candidates;
+    const Level& top = levels[LEVELS - 1];
+    top.for_each([&](uint64_t key, uint64_t) {
+        NodeCoord node = unpack(key);
+        if (candidates.empty() || better(coord(node), coord(candidates.front()))) {
+            candidates.assign(1, node);
+        } else if (coord(node) == coord(candidates.front())) {
+            candidates.push_back(node);
+        }
+    });
+    
+    // Children of the extreme nodes contain every extreme node one level down
+    std::vector<NodeCoord> children;
+    for (int level = LEVELS - 2; level >= 0; --level) {
+        children.clear();
+        for (const NodeCoord& parent : candidates) {
+            for (int dy = 0; dy <= 1; ++dy) {
+                for (int dx = 0; dx <= 1; ++dx) {
+                    NodeCoord child{parent.first * 2 + dx, parent.second * 2 + dy};
+                    if (levels[level].get(pack(child.first, child.second)) == 0) continue;
+                    if (children.empty() || better(coord(child), coord(children.front()))) {
+                        children.assign(1, child);
+                    } else if (coord(child) == coord(children.front())) {
+                        children.push_back(child);
+                    }
+                }
+            }
+        }
+        candidates.swap(children);
+    }
+    out = std::move(candidates);
+}
+
+bool DensityPyramid::edge_chunks(std::vector<NodeCoord>& min_x, std::vector<NodeCoord>& max_x,
+                                 std::vector<NodeCoord>& min_y, std::vector<NodeCoord>& max_y) const {
+    if (empty()) return false;
+    
+    descend_edge(0, false, min_x);
+    descend_edge(0, true, max_x);
+    descend_edge(1, false, min_y);
+    descend_edge(1, true, max_y);
+    return true;
+}
+
+size_t DensityPyramid::memory_usage() const {
+    size_t bytes = sizeof(DensityPyramid);
+    for (const auto& level : levels) {
+        bytes += level.memory_usage();
+    }
+    return bytes;
+}
@@ -0,0 +1,101 @@
+#include "cell_automaton/neighbor_counter.hpp"
+
+bool NeighborCounter::supports(const cell_automaton::rules::Neighborhood& nb) {
+    return nb.kind == cell_automaton::rules::NeighborhoodKind::Moore || nb.kind == cell_automaton::rules::NeighborhoodKind::VonNeumann;
+}
+
+void NeighborCounter::count(const uint8_t* live, int size, int halo, const cell_automaton::rules::Neighborhood& nb, int32_t* out) {
+    if (nb.kind == cell_automaton::rules::NeighborhoodKind::Moore) {
+        count_moore(live, size, halo, nb.radius, out);
+    } else {
+        count_von_neumann(live, size, halo, nb.radius, out);
+    }
+}
+
+void NeighborCounter::count_moore(const uint8_t* live, int size, int halo, int radius, int32_t* out) {
+    const int tile_size = size + 2 * halo;
+    // sat(x, y) = live cells in [0, x) x [0, y); row and column 0 are zero
+    const int stride = tile_size + 1;
+    table_a.assign(size_t(stride) * stride, 0);
+    int32_t* sat = table_a.data();
+    
+    for (int y = 0; y < tile_size; ++y) {
+        int32_t row_sum = 0;
+        for (int x = 0; x < tile_size; ++x) {
+            row_sum += live[y * tile_size + x];
+            sat[(y + 1) * stride + x + 1] = sat[y * stride + x + 1] + row_sum;
+        }
+    }
+    
+    for (int ly = 0; ly < size; ++ly) {
+        const int top = ly + halo - radius;
+        const int bottom = ly + halo + radius + 1;
+        for (int lx = 0; lx < size; ++lx) {
+            const int left = lx + halo - radius;
+            const int right = lx + halo + radius + 1;
+            int32_t box = sat[bottom * stride + right] - sat[top * stride + right]
+                        - sat[bottom * stride + left] + sat[top * stride + left];
+            out[ly * size + lx] = box - live[(ly + halo) * tile_size + lx + halo];
+        }
+    }
+}
+
+void NeighborCounter::count_von_neumann(const uint8_t* live, int size, int halo, int radius, int32_t* out) {
+    const int tile_size = size + 2 * halo;
+    // Prefix sums along both diagonals, padded by one cell on every side:
+    //   diag(x, y) = live(x, y) + diag(x - 1, y - 1)
+    //   anti(x, y) = live(x, y) + anti(x - 1, y + 1)
+    const int stride = tile_size + 2;
+    table_a.assign(size_t(stride) * stride, 0);
+    table_b.assign(size_t(stride) * stride, 0);
+    int32_t* diag = table_a.data();
+    int32_t* anti = table_b.data();
+    auto at = [stride](int x, int y) { return (y + 1) * stride + (x + 1); };
+    
+    for (int y = 0; y < tile_size; ++y) {
+        for (int x = 0; x < tile_size; ++x) {
+            diag[at(x, y)] = live[y * tile_size + x] + diag[at(x - 1, y - 1)];
+        }
+    }
+    for (int y = tile_size - 1; y >= 0; --y) {
+        for (int x = 0; x < tile_size; ++x) {
+            anti[at(x, y)] = live[y * tile_size + x] + anti[at(x - 1, y + 1)];
+        }
+    }
+    
+    // Inclusive segments of n + 1 cells starting at (x0, y0), stepping (+1, +1) or (+1, -1)
+    auto diag_seg = [&](int x0, int y0, int n) { return diag[at(x0 + n, y0 + n)] - diag[at(x0 - 1, y0 - 1)]; };
+    auto anti_seg = [&](int x0, int y0, int n) { return anti[at(x0 + n, y0 - n)] - anti[at(x0 - 1, y0 + 1)]; };
+    
+    const int r = radius;
+    
+    // Diamond around the first interior cell, summed directly once per tile
+    int32_t column = 0;
+    for (int dy = -r; dy <= r; ++dy) {
+        const int span = r - (dy < 0 ? -dy : dy);
+        for (int dx = -span; dx <= span; ++dx) {
+            column += live[(halo + dy) * tile_size + halo + dx];
+        }
+    }
+    
+    for (int ly = 0; ly < size; ++ly) {
+        const int y = ly + halo;
+        if (ly > 0) {
+            // Slide down from (halo, y - 1): add the bottom edge, drop the top edge
+            const int x = halo, py = y - 1;
+            column += diag_seg(x - r, py + 1, r) + anti_seg(x + 1, py + r, r - 1)
+                    - anti_seg(x - r, py, r) - diag_seg(x + 1, py - r + 1, r - 1);
+        }
+        
+        int32_t diamond = column;
+        for (int lx = 0; lx < size; ++lx) {
+            const int x = lx + halo;
+            out[ly * size + lx] = diamond - live[y * tile_size + x];
+            if (lx + 1 < size) {
+                // Slide right: add the right edge of the next diamond, drop our left edge
+                diamond += diag_seg(x + 1, y - r, r) + anti_seg(x + 1, y + r, r - 1)
+                         - anti_seg(x - r, y, r) - diag_seg(x - r + 1, y + 1, r - 1);
+            }
+        }
+    }
+}
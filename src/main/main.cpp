@@ -1,13 +1,27 @@
 #include <iostream>
+#include <thread>
+#include <span>
 #include "cell_automaton/cellular_automaton.hpp"
-#include "cell_automaton/cellular_automaton.hpp"
+#include "cell_automaton/cellular_automaton_impl.hpp"
 #include "rules/conway_rule.hpp"
+#include "rules/larger_than_life_rule.hpp"
 #include "patterns/patterns_library.hpp"
 
 using namespace cell_automaton;
 using namespace cell_automaton::rules;
 using namespace cell_automaton::patterns;
 
+// Fredkin's replicator on the von Neumann neighborhood, written as a plain
+// functor rule: CellularAutomaton<bool, ParityRule> inlines it into the kernel
+struct ParityRule {
+    Neighborhood neighborhood() const { return Neighborhood::von_neumann(1); }
+    bool apply(bool, std::span<const bool> neighbors) const {
+        bool parity = false;
+        for (bool neighbor : neighbors) parity ^= neighbor;
+        return parity;
+    }
+};
+
 // ============================================================================
 // Test harness - extracted from the main() function
 // ============================================================================
@@ -30,10 +44,95 @@ int main() {
         ca.run(10);
         print_pattern(ca, 5, 5, 20, 20);
         
+        std::cout << "Generation: " << ca.get_generation() << std::endl;
+        std::cout << "Active chunks: " << ca.get_active_chunks() << std::endl;
+        if (auto box = ca.bounding_box()) {
+            std::cout << "Bounding box: (" << box->min_x << ", " << box->min_y << ") - ("
+                      << box->max_x << ", " << box->max_y << ")\n\n";
+        }
+    }
+
+    // Test 2: Snapshots keep their generation while the automaton steps
+    {
+        std::cout << "Test 2: Snapshot isolation - glider\n";
+        auto rule = std::make_unique<ConwayRule>();
+        CellularAutomaton<bool> ca(std::move(rule), false);
+
+        create_glider(ca, 0, 0);
+        ca.publish();
+        auto pinned = ca.snapshot();
+        ca.run(4);
+
+        std::cout << "Pinned generation " << pinned.get_generation() << ":\n";
+        print_pattern(pinned, -1, -1, 6, 6);
+        std::cout << "Latest generation " << ca.snapshot().get_generation() << ":\n";
+        print_pattern(ca.snapshot(), -1, -1, 6, 6);
+    }
+
+    // Test 3: Range-5 Larger than Life rule
+    {
+        auto rule = std::make_unique<LargerThanLifeRule>(LargerThanLifeRule::bosco());
+        std::cout << "Test 3: Larger than Life - " << rule->notation() << "\n";
+        CellularAutomaton<bool> ca(std::move(rule), false);
+
+        create_random_soup(ca, 0, 0, 24, 24, 0.5, 7);
+        ca.run(20);
+        print_pattern(ca, -4, -4, 32, 32);
+
         std::cout << "Generation: " << ca.get_generation() << std::endl;
         std::cout << "Active chunks: " << ca.get_active_chunks() << "\n\n";
     }
-    
+
+    // Test 4: Edits queued from another thread land between generations
+    {
+        std::cout << "Test 4: Queued edits - blinker stamped from a producer thread\n";
+        auto rule = std::make_unique<ConwayRule>();
+        CellularAutomaton<bool> ca(std::move(rule), false);
+
+        std::thread producer([&ca] {
+            ca.enqueue_pattern(2, 2, {{0, 0, true}, {1, 0, true}, {2, 0, true}});
+            ca.enqueue_cell(8, 8, true);
+        });
+        producer.join();
+        ca.step();
+        print_pattern(ca, 0, 0, 10, 10);
+        std::cout << "Generation: " << ca.get_generation() << "\n\n";
+    }
+
+    // Test 5: A functor rule, statically dispatched
+    {
+        std::cout << "Test 5: Functor rule - parity replicator, 4 copies after 4 generations\n";
+        CellularAutomaton<bool, ParityRule> ca(ParityRule{}, false);
+
+        ca.set_cell(0, 0, true);
+        ca.set_cell(1, 0, true);
+        ca.set_cell(0, 1, true);
+        ca.run(4);
+        print_pattern(ca, -6, -6, 14, 14);
+        std::cout << "Generation: " << ca.get_generation() << "\n\n";
+    }
+
+    // Test 6: A frozen chunk dies out and is rebuilt with its old content
+    {
+        std::cout << "Test 6: Frozen chunk reborn - block across a chunk border\n";
+        auto rule = std::make_unique<ConwayRule>();
+        CellularAutomaton<bool> ca(std::move(rule), false);
+
+        for (int32_t y : {10, 11}) {
+            for (int32_t x : {63, 64}) ca.set_cell(x, y, true);
+        }
+        ca.run(8);
+        // Only the x < 64 chunk changes: it empties, then regrows its half block
+        ca.set_cell(63, 10, false);
+        ca.set_cell(63, 11, false);
+        ca.set_cell(62, 8, true);
+        ca.set_cell(63, 8, true);
+        ca.set_cell(62, 11, true);
+        ca.set_cell(62, 13, true);
+        ca.run(2);
+        print_pattern(ca, 58, 6, 67, 15);
+        std::cout << "Generation: " << ca.get_generation() << "\n\n";
+    }
     
     std::cout << "\n=== All tests completed! ===\n";
     return 0;
@@ -2,9 +2,13 @@
 // Pattern creation helpers - these were missing from the implementation
 // ============================================================================
 
-#include "cell_automaton/cellular_automaton.hpp"
+#include "patterns/patterns_library.hpp"
+#include "patterns/soup_rng.hpp"
 #include <iostream>
-#include <cstdlib>
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 
 namespace cell_automaton {
@@ -42,13 +46,84 @@ void create_r_pentomino(CellularAutomaton<bool>& ca, int x, int y) {
  * @param width Width of the soup area
  * @param height Height of the soup area
  * @param density Probability of each cell being alive (0.0 to 1.0)
+ * @param seed Soup seed; the same seed always yields the same soup
+ * @param threads Worker threads, 0 picks std::thread::hardware_concurrency()
+ *
+ * Every chunk draws its rows from its own SoupRng stream, so the soup is
+ * identical for any thread count. Chunks are generated in parallel and then
+ * stamped into the automaton in one bulk write per chunk.
  */
-void create_random_soup(CellularAutomaton<bool>& ca, int x, int y, int width, int height, double density = 0.3) {
-    for (int dy = 0; dy < height; ++dy) {
-        for (int dx = 0; dx < width; ++dx) {
-            if (static_cast<double>(rand()) / RAND_MAX < density) {
-                ca.set_cell(x + dx, y + dy, true);
+void create_random_soup(CellularAutomaton<bool>& ca, int x, int y, int width, int height,
+                        double density, uint64_t seed, unsigned threads) {
+    if (width <= 0 || height <= 0 || density <= 0.0) return;
+    
+    constexpr int32_t size = static_cast<int32_t>(CHUNK_SIZE);
+    auto floor_div = [](int32_t v) { return (v >= 0 ? v : v - size + 1) / size; };
+    
+    const int32_t x_end = x + width;
+    const int32_t y_end = y + height;
+    const int32_t first_cx = floor_div(x), last_cx = floor_div(x_end - 1);
+    const int32_t first_cy = floor_div(y), last_cy = floor_div(y_end - 1);
+    const int64_t columns = int64_t(last_cx) - first_cx + 1;
+    const int64_t total_chunks = columns * (int64_t(last_cy) - first_cy + 1);
+    
+    const uint32_t threshold = static_cast<uint32_t>(std::lround(std::min(density, 1.0) * 65536.0));
+    
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    
+    // Bound scratch memory for very large soups
+    constexpr int64_t BATCH_CHUNKS = 4096;
+    std::vector<ChunkBits> batch;
+    
+    for (int64_t batch_start = 0; batch_start < total_chunks; batch_start += BATCH_CHUNKS) {
+        const int64_t batch_size = std::min(BATCH_CHUNKS, total_chunks - batch_start);
+        batch.assign(batch_size, ChunkBits{});
+        
+        auto generate = [&](int64_t i) {
+            const int64_t index = batch_start + i;
+            const int32_t cx = first_cx + static_cast<int32_t>(index % columns);
+            const int32_t cy = first_cy + static_cast<int32_t>(index / columns);
+            const int32_t base_x = cx * size;
+            const int32_t base_y = cy * size;
+            
+            // Columns of this chunk that fall inside [x, x_end)
+            const int lo = std::max(x, base_x) - base_x;
+            const int hi = std::min(x_end, base_x + size) - base_x;
+            const uint64_t column_mask = (hi - lo == 64) ? ~uint64_t{0}
+                                                         : (((uint64_t{1} << (hi - lo)) - 1) << lo);
+            
+            SoupRng rng = SoupRng::for_stream(seed, cx, cy);
+            ChunkBits& rows = batch[i];
+            for (int ly = 0; ly < size; ++ly) {
+                // Always draw the row so a cell's value depends only on seed and position
+                uint64_t bits = rng.bernoulli_word(threshold);
+                int32_t world_y = base_y + ly;
+                rows[ly] = (world_y >= y && world_y < y_end) ? (bits & column_mask) : 0;
             }
+        };
+        
+        const unsigned workers = static_cast<unsigned>(std::min<int64_t>(threads, batch_size));
+        if (workers <= 1) {
+            for (int64_t i = 0; i < batch_size; ++i) generate(i);
+        } else {
+            std::atomic<int64_t> next{0};
+            std::vector<std::thread> pool;
+            pool.reserve(workers);
+            for (unsigned t = 0; t < workers; ++t) {
+                pool.emplace_back([&] {
+                    for (int64_t i = next++; i < batch_size; i = next++) generate(i);
+                });
+            }
+            for (auto& worker : pool) worker.join();
+        }
+        
+        for (int64_t i = 0; i < batch_size; ++i) {
+            const int64_t index = batch_start + i;
+            ca.stamp_chunk_bits(first_cx + static_cast<int32_t>(index % columns),
+                                first_cy + static_cast<int32_t>(index / columns),
+                                batch[i], true);
         }
     }
 }
@@ -12,6 +12,10 @@ bool ConwayRule::apply(bool current, const std::vector<bool>& neighbors) const {
         }
     }
     
+    return apply_count(current, live_neighbors);
+}
+
+bool ConwayRule::apply_count(bool current, int live_neighbors) const {
     if (current) {
         // Live cell: survives with 2 or 3 neighbors
         return live_neighbors == 2 || live_neighbors == 3;
@@ -16,6 +16,12 @@ public:
             if (neighbor) live_neighbors++;
         }
         
+        return apply_count(current, live_neighbors);
+    }
+    
+    bool is_totalistic() const override { return true; }
+    
+    bool apply_count(bool current, int live_neighbors) const override {
         if (current) {
             // Live cell: survives with 2 or 3 neighbors
             return live_neighbors == 2 || live_neighbors == 3;
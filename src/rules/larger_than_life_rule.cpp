@@ -0,0 +1,50 @@
+#include "rules/larger_than_life_rule.hpp"
+#include <stdexcept>
+
+namespace cell_automaton {
+namespace rules {
+
+LargerThanLifeRule::LargerThanLifeRule(Neighborhood nb, bool middle,
+                                       int s_min, int s_max, int b_min, int b_max)
+    : shape(nb), include_center(middle),
+      survive_min(s_min), survive_max(s_max), birth_min(b_min), birth_max(b_max) {
+    if (nb.radius < 1) {
+        throw std::invalid_argument("LargerThanLifeRule: radius must be at least 1");
+    }
+    
+    const char* suffix = nb.kind == NeighborhoodKind::Moore      ? "NM"
+                       : nb.kind == NeighborhoodKind::VonNeumann ? "NN"
+                                                                 : "NH";
+    notation_text = "R" + std::to_string(nb.radius) + ",C0,M" + (middle ? "1" : "0")
+                  + ",S" + std::to_string(s_min) + ".." + std::to_string(s_max)
+                  + ",B" + std::to_string(b_min) + ".." + std::to_string(b_max)
+                  + "," + suffix;
+}
+
+LargerThanLifeRule LargerThanLifeRule::bosco() {
+    return LargerThanLifeRule(Neighborhood::moore(5), true, 34, 58, 34, 45);
+}
+
+bool LargerThanLifeRule::apply(bool current, const std::vector<bool>& neighbors) const {
+    int live_neighbors = 0;
+    for (bool neighbor : neighbors) {
+        if (neighbor) live_neighbors++;
+    }
+    return apply_count(current, live_neighbors);
+}
+
+bool LargerThanLifeRule::apply_count(bool current, int live_neighbors) const {
+    int count = live_neighbors + (include_center && current ? 1 : 0);
+    if (current) {
+        return count >= survive_min && count <= survive_max;
+    } else {
+        return count >= birth_min && count <= birth_max;
+    }
+}
+
+std::unique_ptr<Rule<bool>> LargerThanLifeRule::clone() const {
+    return std::make_unique<LargerThanLifeRule>(*this);
+}
+
+} // namespace rules
+} // namespace cell_automaton
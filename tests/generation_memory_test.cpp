@@ -0,0 +1,71 @@
+#include "cell_automaton/cellular_automaton.hpp"
+#include "rules/conway_rule.hpp"
+#include "patterns/patterns_library.hpp"
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Memory held for generations readers no longer pin, and for a world that
+// has shrunk, must be given back: memory_usage() has to drop once snapshots
+// are released and once a transient pattern has died out.
+
+using namespace cell_automaton;
+
+static bool report(const char* name, size_t before, size_t after, bool ok) {
+    std::cout << std::left << std::setw(40) << name << std::right << std::setw(12) << before
+              << " -> " << std::setw(10) << after << " bytes" << (ok ? "  ok\n" : "  FAILED\n");
+    return ok;
+}
+
+// ============================================================================
+// Checks
+// ============================================================================
+
+// Generations pinned by snapshots are released once the readers let go
+bool check_released_snapshots() {
+    CellularAutomaton<bool> ca(std::make_unique<rules::ConwayRule>(), false);
+    patterns::create_random_soup(ca, 0, 0, 1024, 1024, 0.35);
+    ca.publish();
+
+    std::vector<CellularAutomaton<bool>::Snapshot> pinned;
+    for (int i = 0; i < 8; ++i) {
+        pinned.push_back(ca.snapshot());
+        ca.step();
+    }
+    const size_t held = ca.memory_usage().total_bytes();
+
+    pinned.clear();
+    ca.publish();
+    const size_t released = ca.memory_usage().total_bytes();
+
+    // Eight pinned generations against the double buffer
+    return report("released snapshots", held, released, released * 2 < held);
+}
+
+// Chunk maps and density pyramid levels shrink after a transient peak
+bool check_transient_peak() {
+    CellularAutomaton<bool> ca(std::make_unique<rules::ConwayRule>(), false);
+
+    // A lone cell in each of 64 x 64 chunks dies in one generation; a block survives
+    constexpr int32_t size = static_cast<int32_t>(CHUNK_SIZE);
+    for (int32_t y = 0; y < 64; ++y) {
+        for (int32_t x = 0; x < 64; ++x) {
+            ca.set_cell(x * size + 10, y * size + 10, true);
+        }
+    }
+    for (int i = 0; i < 4; ++i) ca.set_cell(20 + i % 2, 20 + i / 2, true);
+    ca.publish();
+    const size_t peak = ca.memory_usage().total_bytes();
+
+    ca.run(4);
+    const size_t settled = ca.memory_usage().total_bytes();
+    return report("transient peak", peak, settled, settled * 16 < peak);
+}
+
+int main() {
+    bool ok = check_released_snapshots();
+    ok &= check_transient_peak();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+#include "cell_automaton/cellular_automaton.hpp"
+#include "rules/conway_rule.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Steady-state step() must run entirely out of reused scratch storage: a
+// world of oscillators and a dense still life never grows, so after warmup
+// no generation may touch the heap.
+
+// ============================================================================
+// Allocation Counting
+// ============================================================================
+// Replaces the global allocation functions of this test binary only.
+
+static std::atomic<size_t> allocation_count{0};
+
+static void* counted_alloc(size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size) { return counted_alloc(size); }
+void* operator new[](size_t size) { return counted_alloc(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+using namespace cell_automaton;
+
+// ============================================================================
+// Fixtures
+// ============================================================================
+
+// Life-like rule over any state type: non-default cells count as live and
+// births take state 1
+template<typename StateT>
+class LifeLikeRule : public rules::Rule<StateT> {
+public:
+    StateT apply(StateT current, const std::vector<StateT>& neighbors) const override {
+        int live_neighbors = 0;
+        for (StateT neighbor : neighbors) {
+            live_neighbors += neighbor != StateT{};
+        }
+        return apply_count(current, live_neighbors);
+    }
+
+    bool is_totalistic() const override { return true; }
+
+    StateT apply_count(StateT current, int live_neighbors) const override {
+        if (current != StateT{}) {
+            return (live_neighbors == 2 || live_neighbors == 3) ? current : StateT{};
+        }
+        return live_neighbors == 3 ? StateT(1) : StateT{};
+    }
+
+    std::unique_ptr<rules::Rule<StateT>> clone() const override {
+        return std::make_unique<LifeLikeRule>(*this);
+    }
+
+    const char* name() const override { return "Life-like"; }
+};
+
+template<typename StateT>
+std::unique_ptr<rules::Rule<StateT>> make_default_rule() {
+    if constexpr (std::is_same_v<StateT, bool>) {
+        return std::make_unique<rules::ConwayRule>();
+    } else {
+        return std::make_unique<LifeLikeRule<StateT>>();
+    }
+}
+
+template<typename StateT> const char* state_name();
+template<> const char* state_name<bool>() { return "bool"; }
+template<> const char* state_name<uint8_t>() { return "uint8_t"; }
+template<> const char* state_name<int>() { return "int"; }
+
+template<typename StateT>
+void stamp_steady_world(CellularAutomaton<StateT>& ca) {
+    // Blinkers at a pitch of 5 straddling chunk borders on both sides of the origin
+    for (int32_t y = -150; y < 150; y += 5) {
+        for (int32_t x = -150; x < 150; x += 5) {
+            for (int32_t i = 0; i < 3; ++i) ca.set_cell(x + i, y, StateT(1));
+        }
+    }
+    // Blocks at a pitch of 3: a still life dense enough for dense chunk storage
+    for (int32_t y = 256; y < 384; y += 3) {
+        for (int32_t x = 256; x < 384; x += 3) {
+            for (int32_t i = 0; i < 4; ++i) ca.set_cell(x + i % 2, y + i / 2, StateT(1));
+        }
+    }
+}
+
+// ============================================================================
+// Checks
+// ============================================================================
+
+/**
+ * Allocations made by `steps` calls of run() after `warmup` generations.
+ *
+ * @param mode "adaptive", "dense" (set_adaptive(false)) or "blocked"
+ *             (temporal blocking picked automatically)
+ */
+template<typename StateT>
+size_t count_step_allocations(const std::string& mode, int warmup, int steps) {
+    CellularAutomaton<StateT> ca(make_default_rule<StateT>(), StateT{});
+    if (mode == "dense") ca.set_adaptive(false);
+    if (mode == "blocked") ca.set_temporal_blocking(0);
+    stamp_steady_world(ca);
+
+    const int64_t per_run = mode == "blocked" ? ca.get_temporal_blocking() : 1;
+    ca.run(warmup * per_run);
+
+    const size_t before = allocation_count.load();
+    for (int i = 0; i < steps; ++i) {
+        ca.run(per_run);
+    }
+    return allocation_count.load() - before;
+}
+
+template<typename StateT>
+bool check_step_allocations() {
+    bool ok = true;
+    for (const char* mode : {"adaptive", "dense", "blocked"}) {
+        const size_t allocations = count_step_allocations<StateT>(mode, 64, 64);
+        std::cout << std::left << std::setw(40) << (std::string(mode) + "/" + state_name<StateT>())
+                  << std::right << std::setw(8) << allocations
+                  << (allocations == 0 ? "  ok\n" : "  FAILED: steady-state step allocated\n");
+        ok &= allocations == 0;
+    }
+    return ok;
+}
+
+int main() {
+    bool ok = check_step_allocations<bool>();
+    ok &= check_step_allocations<uint8_t>();
+    ok &= check_step_allocations<int>();
+    return ok ? 0 : 1;
+}